@@ -0,0 +1,708 @@
+// Host microbenchmarks for the snake storage and the game loop.
+// Built by the native_bench environment in platformio.ini with the Arduino stand-ins
+//	in host/.  Run it with:
+//		pio run -e native_bench && .pio/build/native_bench/program [results.csv] [ms per test]
+// Every result is written to the csv file (bench_results.csv by default) as
+//	benchmark,snake_data_size,length,ns_per_op,ops
+// so that the per tick path can be compared from one build to the next.
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "globals.hpp"
+#include "Snake.hpp"
+#include "RingBuffer.hpp"
+#include "TurnSnake.hpp"
+#include "Bitboard.hpp"
+#include "GameCore.hpp"
+#include "Autopilot.hpp"
+#include "Pathfinder.hpp"
+#include "MultiGame.hpp"
+
+
+// From main.cpp.  The game loop runs on the real globals.
+extern GameCore game;
+extern volatile Direction lastDirectionPressed;
+void updateGame();
+
+
+namespace Bench {
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Result {
+		std::string name;
+		unsigned dataSize;
+		unsigned length;
+		double nsPerOp;
+		unsigned long long ops;
+	};
+
+	std::vector<Result> results;
+	std::chrono::nanoseconds minTime { std::chrono::milliseconds(50) };
+
+	// Stops the optimiser from throwing away work whose result is never used.
+	template <typename T>
+	void keep(const T& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+	// Time 'timed' (which does opsPerCall operations) until minTime has been spent in it.
+	//	'setup' is run before every call and is not timed.
+	template <typename Setup, typename Timed>
+	void measure(const std::string& name, unsigned dataSize, unsigned length, uint32_t opsPerCall, Setup&& setup, Timed&& timed) {
+
+		if (opsPerCall == 0) return;
+
+		setup(); timed(); // Warm up.
+
+		std::chrono::nanoseconds spent { 0 };
+		unsigned long long ops { 0 };
+
+		while (spent < minTime) {
+			setup();
+			const auto start { Clock::now() };
+			timed();
+			spent += Clock::now() - start;
+			ops += opsPerCall;
+		}
+
+		const double nsPerOp { static_cast<double>(spent.count()) / static_cast<double>(ops) };
+		results.push_back({ name, dataSize, length, nsPerOp, ops });
+		printf("%-22s %6u %7u %12.2f\n", name.c_str(), dataSize, length, nsPerOp);
+	}
+
+	template <typename Timed>
+	void measure(const std::string& name, unsigned dataSize, unsigned length, uint32_t opsPerCall, Timed&& timed) {
+		measure(name, dataSize, length, opsPerCall, []() {}, timed);
+	}
+
+
+	// Points that are never packed for boards bigger than the world.
+	using WidePoint = Point<POINT_DATA_TYPE>;
+
+	// Board size for the storage tests.  The game world unless a bigger one is asked for.
+	struct Board {
+		unsigned height { World::World.height() };
+		unsigned width { World::World.width() };
+	};
+
+	// The next direction along a Hamiltonian cycle of the board.  Row 0 runs right,
+	//	the other rows go back and forth over columns 1 and up and column 0 leads
+	//	back to the start.  Following it never runs into the snake until the board is full.
+	//	It turns twice every width segments.
+	Direction cycleDirection(const WidePoint& p, const Board& board = {}) {
+
+#if (LARGE_BOARD == NO)
+		static_assert(World::World.height() % 2 == 0, "The cycle needs an even number of rows.");
+#endif
+
+		if (p.x == 0) return (p.y == 0) ? Direction::RIGHT : Direction::UP;
+		if (p.y % 2 == 1) {
+			if (p.x > 1) return Direction::LEFT;
+			return (p.y == board.height - 1) ? Direction::LEFT : Direction::DOWN;
+		}
+		return (p.x < board.width - 1) ? Direction::RIGHT : Direction::DOWN;
+	}
+
+	// Down and right in turn.  Turns at every segment, the worst case for TurnSnake.
+	Direction stairsDirection(const WidePoint& p, const Board& = {}) {
+		return (p.x == p.y) ? Direction::RIGHT : Direction::DOWN;
+	}
+
+	// Grow a snake along the cycle to the given length.  Snakes longer than the
+	//	board lap over themselves which the storage does not mind.
+	template <typename SnakeT, typename Path = Direction (*)(const WidePoint&, const Board&)>
+	auto build(SnakeT& s, unsigned length, const Board& board = {}, Path path = cycleDirection) {
+		std::decay_t<decltype(s.head())> p {};
+		for (unsigned i { 0 }; i < length; ++i) {
+			s.push(p);
+			p = movePoint(p, path(p, board));
+		}
+		s.setDirection(path(s.head(), board));
+		return p;
+	}
+
+	// Fixed set of board cells to look up, the same for every size.
+	template <typename PointT = PointType>
+	std::vector<PointT> queryPoints(const Board& board = {}) {
+		std::vector<PointT> points;
+		randomSeed(42);
+		for (int i { 0 }; i < 64; ++i)
+			points.push_back({ static_cast<POINT_DATA_TYPE>(random(board.height)),
+							   static_cast<POINT_DATA_TYPE>(random(board.width)) });
+		return points;
+	}
+
+
+	template <SnakeDataSizeType DataSize>
+	void storage(const std::vector<unsigned>& lengths) {
+
+		using S = Snake<DataSize, PointType>;
+		const auto queries { queryPoints() };
+
+		for (const unsigned length : lengths) {
+
+			S start {};
+			if (length + 1 > start.capacity()) continue;
+			const PointType next { build(start, length) };
+
+			S s { start };
+			PointType head { next };
+
+			// One tick worth of storage: a push at the head and a pop at the tail.
+			measure("push+pop", DataSize, length, 64, [&]() {
+				for (int i { 0 }; i < 64; ++i) {
+					s.push(head);
+					keep(s.pop());
+					head = movePoint(head, cycleDirection(head));
+				}
+			});
+
+			const uint32_t pushes { static_cast<uint32_t>((start.capacity() - length < 64) ? start.capacity() - length : 64) };
+			measure("push", DataSize, length, pushes, [&]() { s = start; head = next; }, [&]() {
+				for (uint32_t i { 0 }; i < pushes; ++i) {
+					keep(s.push(head));
+					head = movePoint(head, cycleDirection(head));
+				}
+			});
+
+			const uint32_t pops { (length - 1 < 64) ? length - 1 : 64 };
+			measure("pop", DataSize, length, pops, [&]() { s = start; }, [&]() {
+				for (uint32_t i { 0 }; i < pops; ++i) keep(s.pop());
+			});
+
+			s = start;
+			measure("operator[]", DataSize, length, length, [&]() {
+				for (unsigned i { 0 }; i < length; ++i) keep(s[i]);
+			});
+
+			measure("pointIsInside", DataSize, length, static_cast<uint32_t>(queries.size()), [&]() {
+				for (const auto& q : queries) keep(s.pointIsInside(q));
+			});
+		}
+
+		// The crumb pointer walks the whole buffer and wraps the same way the snake does.
+		uint8_t data[DataSize] {};
+		CrumbPtr cp { data, 0 };
+		measure("CrumbPtr++", DataSize, DataSize * 4, DataSize * 4, [&]() {
+			for (unsigned i { 0 }; i < DataSize * 4u; ++i) {
+				++cp;
+				if (cp.ptr > data + sizeof(data) - 1) cp.ptr = data;
+				keep(cp);
+			}
+		});
+		measure("CrumbPtr--", DataSize, DataSize * 4, DataSize * 4, [&]() {
+			for (unsigned i { 0 }; i < DataSize * 4u; ++i) {
+				--cp;
+				if (cp.ptr < data) cp.ptr = data + (sizeof(data) - 1);
+				keep(cp);
+			}
+		});
+
+		// Ring buffer kept half full so push and pop both wrap.
+		constexpr uint8_t RingSize { (DataSize < 254) ? DataSize : 254 };
+		RingBuffer<uint8_t, RingSize> ring {};
+		for (uint8_t i { 0 }; i < RingSize / 2; ++i) ring.push(i);
+		measure("RingBuffer push+pop", DataSize, RingSize / 2, 64, [&]() {
+			for (uint8_t i { 0 }; i < 64; ++i) {
+				ring.push(i);
+				keep(ring.pop());
+			}
+		});
+	}
+
+
+	// push+pop, pointIsInside and operator[] on snakes of type S that follow path on the
+	//	board.  Lengths that do not fit on the board or in the snake are skipped.
+	template <typename S, typename Path>
+	void shape(const char* pushPop, const char* inside, const char* index, unsigned dataSize,
+			   const Board& board, Path path, const std::vector<unsigned>& lengths) {
+
+		const auto queries { queryPoints<std::decay_t<decltype(S{}.head())>>(board) };
+
+		for (const unsigned length : lengths) {
+
+			if (length + 1 > board.height * board.width) continue;
+			S start {};
+			if (length + 64 > start.capacity()) continue;
+			const auto next { build(start, length, board, path) };
+			if (start.length() != length) continue; // Did not fit.
+
+			S s { start };
+			auto head { next };
+			measure(pushPop, dataSize, length, 64, [&]() {
+				for (int i { 0 }; i < 64; ++i) {
+					if (!s.push(head)) { s = start; head = next; continue; }
+					keep(s.pop());
+					head = movePoint(head, path(head, board));
+				}
+			});
+
+			s = start;
+			measure(inside, dataSize, length, static_cast<uint32_t>(queries.size()), [&]() {
+				for (const auto& q : queries) keep(s.pointIsInside(q));
+			});
+
+			measure(index, dataSize, length, 16, [&]() {
+				for (unsigned i { 0 }; i < 16; ++i) keep(s[(length - 1) * i / 15]);
+			});
+		}
+	}
+
+	// Moves the snake one along path and back again with popHead() and pushTail(), timing
+	//	a move and its undo, and checks it is the same snake after.
+	template <typename S, typename Path>
+	void undo(const char* name, unsigned dataSize, const Board& board, Path path, const std::vector<unsigned>& lengths) {
+
+		for (const unsigned length : lengths) {
+
+			if (length + 1 > board.height * board.width) continue;
+			S start {};
+			const auto next { build(start, length, board, path) };
+			if (start.length() != length) continue;
+
+			S s { start };
+			measure(name, dataSize, length, 64, [&]() {
+				for (int i { 0 }; i < 64; ++i) {
+					const auto tail { s.pop() };
+					s.push(next);
+					keep(s.popHead());
+					s.pushTail(tail);
+				}
+			});
+
+			bool same { s.length() == start.length() && s.turns() == start.turns() };
+			for (unsigned i { 0 }; same && i < length; ++i) same = s[i] == start[i];
+			if (!same) { fprintf(stderr, "%s did not undo at length %u\n", name, length); exit(1); }
+		}
+	}
+
+	// Memory now scales with the turns and not the length.  Snake<255> is as big as the
+	//	crumb ring gets so it is compared up to 1021 segments and the turn list on from there.
+	//	Coordinates are uint8_t so 256x256 is the biggest board.
+	void turns(const std::vector<unsigned>& lengths) {
+
+		using Crumbs = Snake<255, WidePoint>;
+		using Turns = TurnSnake<1024, WidePoint, uint32_t>;
+		printf("sizeof Snake<255> %u, TurnSnake<1024> %u bytes\n", unsigned(sizeof(Crumbs)), unsigned(sizeof(Turns)));
+
+		const Board world {}, medium { 64, 64 }, large { 256, 256 };
+
+		shape<Crumbs>("Snake push+pop", "Snake pointIsInside", "Snake operator[]", 255, world, cycleDirection, lengths);
+		shape<Turns>("TurnSnake push+pop", "TurnSnake pointIsInside", "TurnSnake operator[]", 1024, world, cycleDirection, lengths);
+		shape<Crumbs>("Snake push+pop 64x64", "Snake pointIsInside 64x64", "Snake operator[] 64x64", 255, medium, cycleDirection, lengths);
+		shape<Turns>("TurnSnake push+pop 64x64", "TurnSnake pointIsInside 64x64", "TurnSnake operator[] 64x64", 1024, medium, cycleDirection, lengths);
+		shape<Crumbs>("Snake push+pop 256x256", "Snake pointIsInside 256x256", "Snake operator[] 256x256", 255, large, cycleDirection, lengths);
+		shape<Turns>("TurnSnake push+pop 256x256", "TurnSnake pointIsInside 256x256", "TurnSnake operator[] 256x256", 1024, large, cycleDirection, lengths);
+
+		// The stairs leave the board after 511 segments.
+		const std::vector<unsigned> stairs { 16, 159, 500 };
+		shape<Crumbs>("Snake push+pop stairs", "Snake pointIsInside stairs", "Snake operator[] stairs", 255, large, stairsDirection, stairs);
+		shape<Turns>("TurnSnake push+pop stairs", "TurnSnake pointIsInside stairs", "TurnSnake operator[] stairs", 1024, large, stairsDirection, stairs);
+
+		undo<Turns>("TurnSnake move+undo", 1024, world, cycleDirection, lengths);
+		undo<Turns>("TurnSnake move+undo stairs", 1024, large, stairsDirection, stairs);
+	}
+
+
+	// The snake follows the cycle so the game never ends.  Anything it eats is trimmed
+	//	off between batches to hold the length near the one asked for.
+	template <typename Tick>
+	void gameTicks(const std::string& name, GameCore& core, const std::vector<unsigned>& lengths, Tick&& tick) {
+
+		const unsigned longest { World::cells() - 2u };
+
+		for (const unsigned length : lengths) {
+
+			if (length > longest || length + 1 > core.snake().capacity()) continue;
+
+			core.reset(1);
+			SnakeType s {};
+			build(s, length);
+			core.setSnake(s);
+
+			measure(name, SNAKE_DATA_SIZE, length, 64, [&]() {
+				if (core.snake().length() == length) return;
+				s = core.snake();
+				while (s.length() > length) s.pop();
+				core.setSnake(s);
+			}, [&]() {
+				for (int i { 0 }; i < 64; ++i) tick(cycleDirection(core.snake().head()));
+			});
+		}
+	}
+
+	// The rules on their own and the whole game tick with the display calls going to
+	//	the stand-in driver.
+	void game(const std::vector<unsigned>& lengths) {
+
+		GameCore core {};
+		gameTicks("GameCore::step", core, lengths, [&](Direction d) { keep(core.step(d)); });
+
+		gameTicks("updateGame", ::game, lengths, [](Direction d) {
+			lastDirectionPressed = d;
+			updateGame();
+		});
+	}
+
+
+	// The area the head could reach after a move by a breadth first search of the world
+	//	that looks each cell up in the snake.  What the bitboard flood fill replaces.
+	uint16_t reachableBySearch(const GameCore& core, Direction d) {
+
+		using World::World;
+		const auto& snake { core.snake() };
+		auto blocked { [&](const PointType& p) { return p != snake.tail() && snake.pointIsInside(p); } };
+
+		if (core.detectPlayerOutOfArea(snake.head(), d)) return 0;
+		const PointType start { movePoint(snake.head(), d) };
+		if (blocked(start)) return 0;
+
+		std::vector<bool> seen(World::cells(), false);
+		std::vector<PointType> queue { start };
+		seen[start.y * World.width() + start.x] = true;
+		for (size_t i { 0 }; i < queue.size(); ++i) {
+			for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) {
+				const auto dir { static_cast<Direction>(n) };
+				if (core.detectPlayerOutOfArea(queue[i], dir)) continue;
+				const PointType q { movePoint(queue[i], dir) };
+				if (seen[q.y * World.width() + q.x] || blocked(q)) continue;
+				seen[q.y * World.width() + q.x] = true;
+				queue.push_back(q);
+			}
+		}
+		return static_cast<uint16_t>(queue.size());
+	}
+
+	// Safe moves and the area each one leaves by walking the crumb ring and by bitboards.
+	//	Both answers are checked against each other.
+	void bitboard(const std::vector<unsigned>& lengths) {
+
+		if (World::cells() != WorldBitboard::Cells) return;
+
+		static GameCore core {};
+		for (const unsigned length : lengths) {
+
+			if (length + 2 > World::cells() || length + 1 > core.snake().capacity()) continue;
+			core.reset(1);
+			SnakeType s {};
+			build(s, length);
+			core.setSnake(s);
+
+			const auto board { WorldBitboardGame::from(core) };
+			if (!board.matches(core)) { fprintf(stderr, "Bitboard does not match the snake at length %u\n", length); exit(1); }
+
+			uint8_t snakeMoves { 0 };
+			uint16_t snakeArea[4] {};
+			for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) {
+				const auto d { static_cast<Direction>(n) };
+				if (length > 1 && d == ~core.direction()) continue;
+				snakeArea[n] = reachableBySearch(core, d);
+				if (snakeArea[n] != 0) snakeMoves |= 1 << n;
+				if (snakeArea[n] != board.reachableAfter(d)) { fprintf(stderr, "Flood fills differ at length %u\n", length); exit(1); }
+			}
+			if (snakeMoves != board.safeMoves()) { fprintf(stderr, "Safe moves differ at length %u\n", length); exit(1); }
+
+			measure("Bitboard from snake", SNAKE_DATA_SIZE, length, 1, [&]() { keep(WorldBitboardGame::from(core)); });
+
+			measure("safe moves snake", SNAKE_DATA_SIZE, length, 16, [&]() {
+				for (int i { 0 }; i < 16; ++i) {
+					uint8_t moves { 0 };
+					for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) {
+						const auto d { static_cast<Direction>(n) };
+						if (!core.detectPlayerOutOfArea(core.snake().head(), d) &&
+							!core.detectSelfCollision(movePoint(core.snake().head(), d))) moves |= 1 << n;
+					}
+					keep(moves);
+				}
+			});
+			measure("safe moves bitboard", SNAKE_DATA_SIZE, length, 16, [&]() {
+				for (int i { 0 }; i < 16; ++i) keep(board.safeMoves());
+			});
+
+			measure("flood fill snake", SNAKE_DATA_SIZE, length, 4, [&]() {
+				for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) keep(reachableBySearch(core, static_cast<Direction>(n)));
+			});
+			measure("flood fill bitboard", SNAKE_DATA_SIZE, length, 4, [&]() {
+				for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) keep(board.reachableAfter(static_cast<Direction>(n)));
+			});
+		}
+	}
+
+
+	// The shortest way to the scran and the room left by each move with the tail moving
+	//	away, on 64-bit words and on a word a row as the avr does it.  The two are checked
+	//	against each other.
+	void pathfinder(const std::vector<unsigned>& lengths) {
+
+		using RowPathfinder = Pathfinder<RowBitboard<World::ScreenWorld.height(), World::ScreenWorld.width()>>;
+		if (World::cells() != WorldBitboard::Cells) return;
+
+		static GameCore core {};
+		for (const unsigned length : lengths) {
+
+			if (length + 2 > World::cells() || length + 1 > core.snake().capacity()) continue;
+			core.reset(1);
+			SnakeType s {};
+			build(s, length);
+			core.setSnake(s);
+
+			const auto words { WorldPathfinder::toScran(core) };
+			const auto rows { RowPathfinder::toScran(core) };
+			if (words.length != rows.length || words.first != rows.first) { fprintf(stderr, "Paths differ at length %u\n", length); exit(1); }
+			for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) {
+				const auto d { static_cast<Direction>(n) };
+				if (WorldPathfinder::reachableAfter(core, d) != RowPathfinder::reachableAfter(core, d)) { fprintf(stderr, "Vacating flood fills differ at length %u\n", length); exit(1); }
+			}
+
+			measure("BFS to scran 64-bit", SNAKE_DATA_SIZE, length, 1, [&]() { keep(WorldPathfinder::toScran(core)); });
+			measure("BFS to scran row", SNAKE_DATA_SIZE, length, 1, [&]() { keep(RowPathfinder::toScran(core)); });
+			measure("vacating fill 64-bit", SNAKE_DATA_SIZE, length, 4, [&]() {
+				for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) keep(WorldPathfinder::reachableAfter(core, static_cast<Direction>(n)));
+			});
+			measure("vacating fill row", SNAKE_DATA_SIZE, length, 4, [&]() {
+				for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) keep(RowPathfinder::reachableAfter(core, static_cast<Direction>(n)));
+			});
+		}
+	}
+
+#if (LARGE_BOARD == NO)
+	// One decision of the autopilot.  It should cost the same at every length.  On the host
+	//	this includes reading micros() twice for its cycle count.
+	void autopilot(const std::vector<unsigned>& lengths) {
+
+		static GameCore core {};
+		for (const unsigned length : lengths) {
+
+			if (length + 2 > World::cells() || length + 1 > core.snake().capacity()) continue;
+			core.reset(1);
+			SnakeType s {};
+			build(s, length);
+			core.setSnake(s);
+
+			measure("autopilot decision", SNAKE_DATA_SIZE, length, 1, [&]() { keep(Autopilot::nextDirection(core)); });
+		}
+	}
+
+	// Towards the scran without running into anything if it can, for the multi snake games.
+	template <uint8_t Snakes>
+	Direction chase(const MultiGame<Snakes>& g, uint8_t i) {
+		const auto& s { g.snake(i) };
+		Direction best { Direction::UP };
+		int bestDistance { 1000 };
+		for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) {
+			const auto d { static_cast<Direction>(n) };
+			if ((s.getDirection() != Direction::NONE && d == ~s.getDirection()) || MultiGame<Snakes>::leaves(s.head(), d)) continue;
+			const PointType q { movePoint(s.head(), d) };
+			if (g.taken(q)) continue;
+			const int distance { abs(q.y - g.scran().y) + abs(q.x - g.scran().x) };
+			if (distance < bestDistance) { best = d; bestDistance = distance; }
+		}
+		return best;
+	}
+
+	// Two one segment snakes next to each other that move into each other's cells both die
+	//	rather than passing through, in every game started with one of the first seeds
+	//	that has them side by side.
+	template <uint8_t Snakes>
+	void swapCheck() {
+
+		static MultiGame<Snakes> g {};
+		unsigned games { 0 };
+		for (uint32_t seed { 1 }; seed < 20000; ++seed) {
+			g.reset(seed);
+			const PointType a { g.snake(0).head() }, b { g.snake(1).head() };
+			Direction toB { Direction::NONE };
+			for (uint8_t n { 0 }; n <= static_cast<uint8_t>(Direction::DOWN); ++n) {
+				const auto d { static_cast<Direction>(n) };
+				if (!MultiGame<Snakes>::leaves(a, d) && movePoint(a, d) == b) toB = d;
+			}
+			if (toB == Direction::NONE) continue;
+
+			Direction in[Snakes];
+			GameEvents events[Snakes];
+			for (auto& d : in) d = Direction::NONE;
+			in[0] = toB;
+			in[1] = ~toB;
+			g.step(in, events);
+			if (g.alive(0) || g.alive(1) || !events[0].has(GameEvents::HitSelf) || !events[1].has(GameEvents::HitSelf) || !g.consistent()) {
+				fprintf(stderr, "One segment snakes swapped cells with seed %u\n", seed);
+				exit(1);
+			}
+			++games;
+		}
+		if (games == 0) { fprintf(stderr, "No game had one segment snakes side by side\n"); exit(1); }
+	}
+
+	// Ticks of games with more snakes.  Games are played once by chase() to get their
+	//	inputs, with the occupancy grid checked against the snakes after every tick, then
+	//	the same ticks are timed on their own.  A tick should cost about the same for each
+	//	snake however many there are.  The length is the average length of a snake.
+	template <uint8_t Snakes>
+	void multi(double& oneSnake_ns) {
+
+		using Inputs = std::array<Direction, Snakes>;
+		static MultiGame<Snakes> g {};
+		std::vector<Inputs> inputs;
+		std::vector<size_t> ends;		// Where each game's inputs end.
+		unsigned long long segments { 0 }, snakeTicks { 0 };
+
+		for (uint32_t seed { 1 }; inputs.size() < 4096; ++seed) {
+			g.reset(seed);
+			Direction in[Snakes];
+			GameEvents events[Snakes];
+			while (g.left() != 0) {
+				for (uint8_t i { 0 }; i < Snakes; ++i) in[i] = g.alive(i) ? chase(g, i) : Direction::NONE;
+				g.step(in, events);
+				if (!g.consistent()) { fprintf(stderr, "The occupancy grid does not match %u snakes\n", Snakes); exit(1); }
+				Inputs a;
+				std::copy(in, in + Snakes, a.begin());
+				inputs.push_back(a);
+				for (uint8_t i { 0 }; i < Snakes; ++i) if (g.alive(i)) { segments += g.snake(i).length(); ++snakeTicks; }
+			}
+			ends.push_back(inputs.size());
+		}
+
+		if (Snakes >= 2) swapCheck<Snakes>();
+
+		const unsigned length { static_cast<unsigned>(snakeTicks ? segments / snakeTicks : 0) };
+		measure("multi step " + std::to_string(Snakes), MultiGame<Snakes>::ShareSize, length, static_cast<uint32_t>(inputs.size()), [&]() {
+			size_t t { 0 };
+			for (size_t game { 0 }; game < ends.size(); ++game) {
+				g.reset(static_cast<uint32_t>(game + 1));
+				for (; t < ends[game]; ++t) {
+					Direction in[Snakes];
+					GameEvents events[Snakes];
+					std::copy(inputs[t].begin(), inputs[t].end(), in);
+					g.step(in, events);
+					keep(events);
+				}
+			}
+		});
+
+		// Snakes die so there are fewer than Snakes moving in an average tick.
+		const double ns { results.back().nsPerOp * static_cast<double>(inputs.size()) / static_cast<double>(snakeTicks) };
+		if (Snakes == 1) oneSnake_ns = ns;
+		printf("%-22s %6s %7s %12.2f ns a snake, %.2f x one snake's tick\n", "", "", "", ns, ns / oneSnake_ns);
+	}
+
+
+	// What walls add to a tick.  The only new work in step() is the wall check, timed on
+	//	its own, and placing scran is done on the free cells of a level rather than any
+	//	cell.  GameCore::reset() is a push and a scran placed on an empty world so is timed
+	//	on each level.  Level 0 picks cells the way it always has.
+	void levels() {
+
+		if (Levels::count < 2) return;
+
+		const uint8_t* walls { Levels::walls(1) };
+		const auto queries { queryPoints() };
+		measure("wall check", 0, 0, static_cast<uint32_t>(queries.size()), [&]() {
+			for (const auto& q : queries) keep(Levels::wall(walls, q));
+		});
+
+		static GameCore core {};
+		for (uint8_t level { 0 }; level < Levels::count; ++level) {
+			measure("reset level " + std::to_string(level), Levels::freeCells(level), 1, 256, [&]() {
+				for (uint32_t seed { 1 }; seed <= 256; ++seed) {
+					core.reset(seed, level);
+					keep(core.scran());
+				}
+			});
+		}
+	}
+#endif // (LARGE_BOARD == NO)
+
+
+#if (LARGE_BOARD == YES)
+	// From the 160 cells of the screen up to a million.  Each board is timed with a short
+	//	snake and one that fills a tenth of it: a tick, a tick that eats and so has to place
+	//	new scran and the self collision check on its own.  The board size is on the end of
+	//	the names.
+	void scaling() {
+
+		static GameCore core {};
+		const Board boards[] { { 8, 20 }, { 32, 32 }, { 100, 100 }, { 316, 316 }, { 1000, 1000 } };
+
+		for (const Board& board : boards) {
+
+			World::resize(static_cast<POINT_DATA_TYPE>(board.height), static_cast<POINT_DATA_TYPE>(board.width));
+			const std::string cells { " " + std::to_string(World::cells()) };
+			std::vector<unsigned> lengths { 16 };
+			if (World::cells() / 10 > 16) lengths.push_back(World::cells() / 10);
+
+			gameTicks("scale step" + cells, core, lengths, [](Direction d) { keep(core.step(d)); });
+
+			const auto queries { queryPoints(board) };
+			for (const unsigned length : lengths) {
+
+				SnakeType start {};
+				build(start, length, board);
+				core.reset(1);
+
+				measure("scale eat" + cells, SNAKE_DATA_SIZE, length, 1, [&]() {
+					core.setSnake(start);
+					core.setScran(movePoint(start.head(), cycleDirection(start.head(), board)));
+				}, [&]() { keep(core.step(start.getDirection())); });
+
+				core.setSnake(start);
+				measure("scale collision" + cells, SNAKE_DATA_SIZE, length, static_cast<uint32_t>(queries.size()), [&]() {
+					for (const auto& q : queries) keep(core.detectSelfCollision(q));
+				});
+			}
+		}
+		World::resize(World::ScreenWorld.height(), World::ScreenWorld.width());
+	}
+#endif // (LARGE_BOARD == YES)
+
+
+	bool writeResults(const char* path) {
+
+		FILE* f { fopen(path, "w") };
+		if (f == nullptr) return false;
+
+		fprintf(f, "benchmark,snake_data_size,length,ns_per_op,ops\n");
+		for (const auto& r : results)
+			fprintf(f, "%s,%u,%u,%.3f,%llu\n", r.name.c_str(), r.dataSize, r.length, r.nsPerOp, r.ops);
+		fclose(f);
+		return true;
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	const char* path { (argc > 1) ? argv[1] : "bench_results.csv" };
+	if (argc > 2) Bench::minTime = std::chrono::milliseconds(atol(argv[2]));
+
+	const std::vector<unsigned> lengths { 1, 2, 8, 16, 32, 64, 128, 159, 256, 512, 1000 };
+	const std::vector<unsigned> longLengths { 16, 159, 512, 1000, 4000, 16000, 64000 };
+
+	printf("%-22s %6s %7s %12s\n", "benchmark", "size", "length", "ns/op");
+	Bench::storage<4>(lengths);
+	Bench::storage<SNAKE_DATA_SIZE>(lengths);
+	Bench::storage<128>(lengths);
+	Bench::storage<255>(lengths);
+	Bench::turns(longLengths);
+	Bench::game(lengths);
+	Bench::bitboard(lengths);
+	Bench::pathfinder(lengths);
+#if (LARGE_BOARD == NO)
+	Bench::autopilot(lengths);
+	double oneSnake_ns { 0 };
+	Bench::multi<1>(oneSnake_ns);
+	Bench::multi<2>(oneSnake_ns);
+	Bench::multi<4>(oneSnake_ns);
+	Bench::levels();
+#endif
+#if (LARGE_BOARD == YES)
+	Bench::scaling();
+#endif
+
+	if (!Bench::writeResults(path)) {
+		fprintf(stderr, "Could not write %s\n", path);
+		return 1;
+	}
+	printf("Results written to %s\n", path);
+	return 0;
+}
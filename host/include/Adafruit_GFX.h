@@ -0,0 +1,47 @@
+#ifndef __HOST_ADAFRUIT_GFX_H_
+#define __HOST_ADAFRUIT_GFX_H_
+
+// Host stand-in for the Adafruit GFX library.  Drawing calls do nothing, text is
+//	measured as the 6x8 built in font so layout code still gets sensible sizes.
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+	Adafruit_GFX(int16_t w, int16_t h) : _width{w}, _height{h} {}
+
+	void drawPixel(int16_t, int16_t, uint16_t) {}
+	void drawLine(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+	void drawRect(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+	void fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+	void drawRoundRect(int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+	void fillRoundRect(int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+	void drawCircle(int16_t, int16_t, int16_t, uint16_t) {}
+	void fillScreen(uint16_t) {}
+
+	void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+	void setTextSize(uint8_t s) { textsize = (s > 0) ? s : 1; }
+	void setTextColor(uint16_t) {}
+	void setTextColor(uint16_t, uint16_t) {}
+	void setTextWrap(bool) {}
+	void setRotation(uint8_t) {}
+
+	void getTextBounds(const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+		*x1 = x; *y1 = y;
+		*w = static_cast<uint16_t>(strlen(str) * 6 * textsize);
+		*h = static_cast<uint16_t>(8 * textsize);
+	}
+
+	int16_t width() const { return _width; }
+	int16_t height() const { return _height; }
+
+	using Print::write;
+	size_t write(uint8_t) override { cursor_x += 6 * textsize; return 1; }
+
+protected:
+	int16_t _width, _height;
+	int16_t cursor_x { 0 }, cursor_y { 0 };
+	uint8_t textsize { 1 };
+};
+
+#endif // __HOST_ADAFRUIT_GFX_H_
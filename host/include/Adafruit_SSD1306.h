@@ -0,0 +1,33 @@
+#ifndef __HOST_ADAFRUIT_SSD1306_H_
+#define __HOST_ADAFRUIT_SSD1306_H_
+
+// Host stand-in for the Adafruit SSD1306 driver.  Keeps a frame buffer of the right
+//	size so code that touches getBuffer() still works but never talks to a screen.
+
+#include <Adafruit_GFX.h>
+
+#define BLACK 0
+#define WHITE 1
+#define INVERSE 2
+#define SSD1306_BLACK BLACK
+#define SSD1306_WHITE WHITE
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+	Adafruit_SSD1306(uint8_t w, uint8_t h) : Adafruit_GFX(w, h) {}
+
+	bool begin(uint8_t = SSD1306_SWITCHCAPVCC, uint8_t = 0) { return true; }
+	void display() {}
+	void clearDisplay() { memset(buffer, 0, sizeof(buffer)); }
+	void dim(bool) {}
+	void invertDisplay(bool) {}
+	uint8_t* getBuffer() { return buffer; }
+
+private:
+	uint8_t buffer[128 * 64 / 8] {};
+};
+
+#endif // __HOST_ADAFRUIT_SSD1306_H_
@@ -0,0 +1,121 @@
+#ifndef __HOST_ARDUINO_H_
+#define __HOST_ARDUINO_H_
+
+// Host Arduino Header
+// A very small stand-in for the Arduino core so that the game logic can be compiled
+//	and run on a PC by the native PlatformIO environments (benchmarks and tools).
+//	Only the parts of the API used by the game are here.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define HOST_BUILD 1
+
+// The Uno's clock.
+#define F_CPU 16000000UL
+
+// There is no separate flash on a PC so these do nothing.
+#define PROGMEM
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+inline uint8_t pgm_read_byte(const void* p) { return *static_cast<const uint8_t*>(p); }
+inline uint16_t pgm_read_word(const void* p) { uint16_t w; memcpy(&w, p, sizeof(w)); return w; }
+inline const void* pgm_read_ptr(const void* p) { const void* q; memcpy(&q, p, sizeof(q)); return q; }
+inline size_t strlen_P(const char* s) { return strlen(s); }
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define HEX 16
+#define DEC 10
+
+// Time.  millis() and micros() count from the first call.
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Pins.  Inputs read HIGH (not pressed) unless set with hostSetPin().
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+void hostSetPin(uint8_t pin, uint8_t value);
+
+// Random numbers, same signatures as the Arduino core.
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+
+class Print;
+
+// No virtual destructor, the same as the Arduino core, so classes that inherit
+//	this can still be literal types.
+class Printable {
+public:
+	virtual size_t printTo(Print& p) const = 0;
+};
+
+// Print writes text through write().  The default discards everything.
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t) { return 1; }
+	size_t write(const char* str) { return write(reinterpret_cast<const uint8_t*>(str), strlen(str)); }
+	virtual size_t write(const uint8_t* buffer, size_t size) {
+		size_t n { 0 };
+		while (size--) n += write(*buffer++);
+		return n;
+	}
+
+	size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+	size_t print(const char* s) { return write(s); }
+	size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+	size_t print(const Printable& x) { return x.printTo(*this); }
+	size_t print(unsigned long n, int base = DEC) { return printNumber(static_cast<long long>(n), base); }
+	size_t print(long n, int base = DEC) { return printNumber(n, base); }
+	size_t print(unsigned int n, int base = DEC) { return printNumber(n, base); }
+	size_t print(int n, int base = DEC) { return printNumber(n, base); }
+	size_t print(unsigned char n, int base = DEC) { return printNumber(n, base); }
+	size_t print(double n) { char b[32]; snprintf(b, sizeof(b), "%.2f", n); return write(b); }
+
+	template <typename T>
+	size_t println(const T& x) { return print(x) + println(); }
+	template <typename T>
+	size_t println(const T& x, int base) { return print(x, base) + println(); }
+	size_t println() { return write("\r\n"); }
+
+private:
+	size_t printNumber(long long n, int base) {
+		char b[24];
+		snprintf(b, sizeof(b), (base == HEX) ? "%llX" : "%lld", n);
+		return write(b);
+	}
+};
+
+// Serial writes to stdout.
+class HostSerial : public Print {
+public:
+	void begin(unsigned long) {}
+	int available() { return 0; }
+	int read() { return -1; }
+	int availableForWrite() { return 63; }		// As much as the uno's transmit buffer.
+	void flush() { fflush(stdout); }
+	using Print::write;
+	size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+};
+
+extern HostSerial Serial;
+
+#endif // __HOST_ARDUINO_H_
@@ -0,0 +1,30 @@
+#ifndef __HOST_EEPROM_H_
+#define __HOST_EEPROM_H_
+
+// Host stand-in for the Arduino EEPROM library.  1 KB held in RAM, erased to 0xFF
+//	like a new ATmega328P.
+
+#include <Arduino.h>
+
+struct EEPROMClass {
+	uint8_t read(int idx) const { return cells[idx]; }
+	void write(int idx, uint8_t val) {
+		++writes;
+		if (writesLeft == 0) return;
+		if (writesLeft > 0) --writesLeft;
+		cells[idx] = val;
+	}
+	void update(int idx, uint8_t val) { if (cells[idx] != val) write(idx, val); }
+	uint16_t length() const { return sizeof(cells); }
+
+	uint8_t cells[1024];
+	// For power cut tests.  Bytes written so far, and once writesLeft more have been
+	//	written the rest are lost until it is set back to -1.
+	uint32_t writes { 0 };
+	int32_t writesLeft { -1 };
+	EEPROMClass() { memset(cells, 0xFF, sizeof(cells)); }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // __HOST_EEPROM_H_
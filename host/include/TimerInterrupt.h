@@ -0,0 +1,16 @@
+#ifndef __HOST_TIMERINTERRUPT_H_
+#define __HOST_TIMERINTERRUPT_H_
+
+// Host stand-in for 'TimerInterrupt' by Khoi Hoang.  Nothing is ever called back;
+//	host programs call the handlers themselves.
+
+#include <Arduino.h>
+
+struct HostTimerInterrupt {
+	void init() {}
+	bool attachInterruptInterval(unsigned long, void (*)()) { return true; }
+};
+
+inline HostTimerInterrupt ITimer1;
+
+#endif // __HOST_TIMERINTERRUPT_H_
@@ -0,0 +1,54 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+EEPROMClass EEPROM;
+
+namespace {
+	const auto startTime { std::chrono::steady_clock::now() };
+	uint8_t pinState[32];
+	bool pinStateSet { false };
+	// Same generator as avr-libc's random() so host runs look like device runs.
+	unsigned long nextRandom { 1 };
+}
+
+unsigned long millis() {
+	return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - startTime).count());
+}
+
+unsigned long micros() {
+	return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - startTime).count());
+}
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+void hostSetPin(uint8_t pin, uint8_t value) {
+	if (!pinStateSet) { memset(pinState, HIGH, sizeof(pinState)); pinStateSet = true; }
+	pinState[pin % sizeof(pinState)] = value;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t pin) { return pinStateSet ? pinState[pin % sizeof(pinState)] : HIGH; }
+void digitalWrite(uint8_t pin, uint8_t value) { hostSetPin(pin, value); }
+int analogRead(uint8_t) { return static_cast<int>(micros() & 0x3FF); }
+
+// Park-Miller minimal standard generator as used by avr-libc.
+static long hostRandom() {
+	long hi, lo, x { static_cast<long>(nextRandom) };
+	if (x == 0) x = 123459876L;
+	hi = x / 127773L;
+	lo = x % 127773L;
+	x = 16807L * lo - 2836L * hi;
+	if (x < 0) x += 0x7fffffffL;
+	nextRandom = static_cast<unsigned long>(x);
+	return x % (0x7fffffffL + 1UL);
+}
+
+long random(long max) { return (max == 0) ? 0 : hostRandom() % max; }
+long random(long min, long max) { return (min >= max) ? min : random(max - min) + min; }
+void randomSeed(unsigned long seed) { if (seed != 0) nextRandom = seed; }
@@ -0,0 +1,59 @@
+#ifndef __AUTOPILOT_HPP_
+#define __AUTOPILOT_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "GameCore.hpp"
+
+// Autopilot
+// Plays the game by itself for demos and for burn in testing of units.  It follows a
+//	Hamiltonian cycle, a path through the world that visits every cell once and comes
+//	back to where it started, so it never crashes and fills the whole board in the end.
+//	The cycle is worked out when compiling and kept in flash as each cell's place on it.
+//
+//	Following the cycle from the tail to the head, the snake's segments are always in
+//	order and every free cell is ahead of the head before the tail.  So a move to a cell
+//	ahead of the head and before the tail only skips free cells and keeps that true.  The
+//	autopilot takes the move that skips the most cells without passing the scran or
+//	reaching the tail.  Each decision looks at the head, the tail, the scran and four
+//	neighbours whatever the length of the snake so it costs the same every tick.  Its
+//	cost in CPU cycles is kept so the tick budget can be checked.
+
+namespace Autopilot {
+
+#if (AUTOPILOT == YES)
+	// Set when the current game is played by the autopilot.
+	extern bool enabled;
+
+	// Time on the splash screen after an autopilot game before the next one starts.
+	constexpr uint16_t restartDelay_ms { 3000 };
+#endif
+
+	// The place of p on the cycle.  0 to World::cells() - 1.
+	uint8_t cycleIndex(const PointType& p);
+
+	/**
+	 * @brief Decide which way to go this tick.
+	 * @param game The game to play.
+	 * @return The direction to give to step().
+	 */
+	Direction decide(const GameCore& game);
+
+	/**
+	 * @brief decide() within a budget.  Once it has a safe move and budget_cycles have gone
+	 *	it stops looking for a longer short cut and takes the move it has.
+	 * @param game The game to play.
+	 * @param budget_cycles CPU cycles it may take.
+	 * @return The direction to give to step().
+	 */
+	Direction decide(const GameCore& game, uint16_t budget_cycles);
+
+	// decide() timed with a CycleCounter for lastCycles() and worstCycles().
+	Direction nextDirection(const GameCore& game);
+
+	// CPU cycles taken by the last decision and the most any decision has taken.
+	uint16_t lastCycles();
+	uint16_t worstCycles();
+}
+
+#endif // __AUTOPILOT_HPP_
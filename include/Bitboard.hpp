@@ -0,0 +1,376 @@
+#ifndef __BITBOARD_HPP_
+#define __BITBOARD_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "GameCore.hpp"
+
+// Bitboards
+// The world as one bit per cell in a few 64-bit words, cell y * Width + x.  The 8x20
+//	world is 160 cells so 3 words.  Questions about the whole board become shifts and
+//	masks of a handful of words: moving every bit one cell is one shift, the cells next
+//	to a set of cells is 4 shifts and a flood fill is a few of those a step.  Walking the
+//	crumb ring with pointIsInside() costs a step for every segment for every cell asked
+//	about.
+//
+//	Meant for the host tools, tests of AI and analysis.  It works on the avr too but
+//	64-bit shifts are slow there.  RowBitboard has the same operations with a word for
+//	each row, as small as the width allows, which suits the avr.
+
+
+template <uint8_t Height, uint8_t Width>
+struct Bitboard {
+
+	static constexpr uint16_t Cells { static_cast<uint16_t>(Height * Width) };
+	static constexpr uint8_t Words { static_cast<uint8_t>((Cells + 63) / 64) };
+
+	uint64_t w[Words] {};
+
+	template <typename PointT>
+	static constexpr uint16_t index(const PointT& p) { return static_cast<uint16_t>(p.y * Width + p.x); }
+
+	bool test(uint16_t i) const { return (w[i / 64] >> (i % 64)) & 1; }
+	void set(uint16_t i) { w[i / 64] |= uint64_t{ 1 } << (i % 64); }
+	void reset(uint16_t i) { w[i / 64] &= ~(uint64_t{ 1 } << (i % 64)); }
+
+	template <typename PointT> bool test(const PointT& p) const { return test(index(p)); }
+	template <typename PointT> void set(const PointT& p) { set(index(p)); }
+	template <typename PointT> void reset(const PointT& p) { reset(index(p)); }
+
+	uint16_t count() const;
+	bool any() const;
+
+	Bitboard operator|(const Bitboard& o) const { Bitboard r; for (uint8_t i { 0 }; i < Words; ++i) r.w[i] = w[i] | o.w[i]; return r; }
+	Bitboard operator&(const Bitboard& o) const { Bitboard r; for (uint8_t i { 0 }; i < Words; ++i) r.w[i] = w[i] & o.w[i]; return r; }
+	Bitboard operator^(const Bitboard& o) const { Bitboard r; for (uint8_t i { 0 }; i < Words; ++i) r.w[i] = w[i] ^ o.w[i]; return r; }
+	// Only the cells of the board are set.  The spare bits at the end stay clear.
+	Bitboard operator~() const { return *this ^ all(); }
+	bool operator==(const Bitboard& o) const;
+	bool operator!=(const Bitboard& o) const { return !(*this == o); }
+
+	// Every bit moved one cell in direction d.  Bits that would leave the board are lost.
+	Bitboard shifted(Direction d) const;
+	// The cells next to the set cells, up, down, left and right.
+	Bitboard neighbours() const;
+
+	/**
+	 * @brief Flood fill.  All of the cells that can be reached from the set cells through free.
+	 * @param free The cells that can be entered.
+	 */
+	Bitboard reachable(const Bitboard& free) const;
+
+	// Call f(y, x) for each set cell, lowest index first.
+	template <typename Function>
+	void forEach(Function f) const;
+
+	// Every cell of the board.
+	static const Bitboard& all();
+	// Every cell in column x.
+	static const Bitboard& column(uint8_t x);
+
+private:
+	// Towards higher indices by n bits (0 < n < 64) and back again.
+	Bitboard shiftedUp(uint8_t n) const;
+	Bitboard shiftedDown(uint8_t n) const;
+};
+
+using WorldBitboard = Bitboard<World::ScreenWorld.height(), World::ScreenWorld.width()>;
+
+
+// A bitboard with one word for each row, bit x of row y for cell (y, x).  A 20 wide row
+//	is a uint32_t.  Up and down move whole rows and left and right shift each row by one
+//	so nothing crosses from one row to the next.  On the avr that is a few byte shifts
+//	where Bitboard shifts 64-bit words across each other.
+template <uint8_t Height, uint8_t Width>
+struct RowBitboard {
+
+	static_assert(Width <= 32, "A row has to fit in a uint32_t.");
+
+	using Row = typename Utility::SelectType<(Width <= 8), uint8_t,
+				typename Utility::SelectType<(Width <= 16), uint16_t, uint32_t>::type>::type;
+
+	static constexpr Row RowMask { static_cast<Row>((Width == 32) ? ~Row{ 0 } : (Row{ 1 } << (Width % 32)) - 1) };
+
+	Row rows[Height] {};
+
+	template <typename PointT> bool test(const PointT& p) const { return (rows[p.y] >> p.x) & 1; }
+	template <typename PointT> void set(const PointT& p) { rows[p.y] |= Row{ 1 } << p.x; }
+	template <typename PointT> void reset(const PointT& p) { rows[p.y] &= ~(Row{ 1 } << p.x); }
+
+	uint16_t count() const;
+	bool any() const;
+
+	RowBitboard operator|(const RowBitboard& o) const { RowBitboard r; for (uint8_t y { 0 }; y < Height; ++y) r.rows[y] = rows[y] | o.rows[y]; return r; }
+	RowBitboard operator&(const RowBitboard& o) const { RowBitboard r; for (uint8_t y { 0 }; y < Height; ++y) r.rows[y] = rows[y] & o.rows[y]; return r; }
+	RowBitboard operator^(const RowBitboard& o) const { RowBitboard r; for (uint8_t y { 0 }; y < Height; ++y) r.rows[y] = rows[y] ^ o.rows[y]; return r; }
+	RowBitboard operator~() const { RowBitboard r; for (uint8_t y { 0 }; y < Height; ++y) r.rows[y] = static_cast<Row>(~rows[y] & RowMask); return r; }
+	bool operator==(const RowBitboard& o) const;
+	bool operator!=(const RowBitboard& o) const { return !(*this == o); }
+
+	// Every bit moved one cell in direction d.  Bits that would leave the board are lost.
+	RowBitboard shifted(Direction d) const;
+	// The cells next to the set cells, up, down, left and right.
+	RowBitboard neighbours() const;
+	// Flood fill.  All of the cells that can be reached from the set cells through free.
+	RowBitboard reachable(const RowBitboard& free) const;
+};
+
+
+// A game as bitboards.  Made from a GameCore and checked against its crumb ring.
+template <uint8_t Height, uint8_t Width>
+struct BitboardGame {
+
+	using Board = Bitboard<Height, Width>;
+
+	Board snake {};
+	Board head {};
+	Board food {};
+	PointType headPoint {};
+	PointType tailPoint {};
+	Direction direction { Direction::NONE };
+
+	static BitboardGame from(const GameCore& game);
+
+	/**
+	 * @brief Check that the bitboards have the same cells as the snake.  Every cell is
+	 *  looked up with pointIsInside() so this is slow.
+	 * @return true if they are the same.
+	 */
+	bool matches(const GameCore& game) const;
+
+	/**
+	 * @brief The moves that do not hit a wall or the snake.  The tail moves out of the way.
+	 * @return One bit for each Direction that is safe, 1 << UP and so on.
+	 */
+	uint8_t safeMoves() const;
+
+	/**
+	 * @brief How many cells the head could reach after moving in d.
+	 * @return The number of cells or 0 if the move is not safe.
+	 */
+	uint16_t reachableAfter(Direction d) const;
+};
+
+using WorldBitboardGame = BitboardGame<World::ScreenWorld.height(), World::ScreenWorld.width()>;
+
+
+// *** Bitboard ***
+
+template <uint8_t Height, uint8_t Width>
+uint16_t Bitboard<Height, Width>::count() const {
+	uint16_t n { 0 };
+	for (uint8_t i { 0 }; i < Words; ++i) n += static_cast<uint16_t>(__builtin_popcountll(w[i]));
+	return n;
+}
+
+template <uint8_t Height, uint8_t Width>
+bool Bitboard<Height, Width>::any() const {
+	uint64_t a { 0 };
+	for (uint8_t i { 0 }; i < Words; ++i) a |= w[i];
+	return a != 0;
+}
+
+template <uint8_t Height, uint8_t Width>
+bool Bitboard<Height, Width>::operator==(const Bitboard& o) const {
+	uint64_t d { 0 };
+	for (uint8_t i { 0 }; i < Words; ++i) d |= w[i] ^ o.w[i];
+	return d == 0;
+}
+
+template <uint8_t Height, uint8_t Width>
+Bitboard<Height, Width> Bitboard<Height, Width>::shiftedUp(uint8_t n) const {
+	Bitboard r;
+	for (uint8_t i { Words - 1 }; i > 0; --i) r.w[i] = (w[i] << n) | (w[i - 1] >> (64 - n));
+	r.w[0] = w[0] << n;
+	return r & all();
+}
+
+template <uint8_t Height, uint8_t Width>
+Bitboard<Height, Width> Bitboard<Height, Width>::shiftedDown(uint8_t n) const {
+	Bitboard r;
+	for (uint8_t i { 0 }; i < Words - 1; ++i) r.w[i] = (w[i] >> n) | (w[i + 1] << (64 - n));
+	r.w[Words - 1] = w[Words - 1] >> n;
+	return r;
+}
+
+template <uint8_t Height, uint8_t Width>
+Bitboard<Height, Width> Bitboard<Height, Width>::shifted(Direction d) const {
+	static_assert(Width < 64, "Rows are shifted in one go so have to be shorter than a word.");
+	switch (d) {
+		case Direction::UP: 	return shiftedDown(Width);
+		case Direction::DOWN: 	return shiftedUp(Width);
+		// Going across the end of a row comes out at the other side of the next one.
+		case Direction::LEFT: 	return shiftedDown(1) & ~column(Width - 1);
+		case Direction::RIGHT: 	return shiftedUp(1) & ~column(0);
+		default: 				return *this;
+	}
+}
+
+template <uint8_t Height, uint8_t Width>
+Bitboard<Height, Width> Bitboard<Height, Width>::neighbours() const {
+	return shifted(Direction::UP) | shifted(Direction::DOWN) | shifted(Direction::LEFT) | shifted(Direction::RIGHT);
+}
+
+template <uint8_t Height, uint8_t Width>
+Bitboard<Height, Width> Bitboard<Height, Width>::reachable(const Bitboard& free) const {
+	Bitboard r { *this & free }, last;
+	do {
+		last = r;
+		r = (r | r.neighbours()) & free;
+	} while (r != last);
+	return r;
+}
+
+template <uint8_t Height, uint8_t Width>
+template <typename Function>
+void Bitboard<Height, Width>::forEach(Function f) const {
+	for (uint8_t i { 0 }; i < Words; ++i) {
+		for (uint64_t b { w[i] }; b != 0; b &= b - 1) {
+			const uint16_t cell { static_cast<uint16_t>(i * 64 + __builtin_ctzll(b)) };
+			f(static_cast<uint8_t>(cell / Width), static_cast<uint8_t>(cell % Width));
+		}
+	}
+}
+
+template <uint8_t Height, uint8_t Width>
+const Bitboard<Height, Width>& Bitboard<Height, Width>::all() {
+	static const Bitboard a { [] {
+		Bitboard b;
+		for (uint16_t i { 0 }; i < Cells; ++i) b.set(i);
+		return b;
+	}() };
+	return a;
+}
+
+template <uint8_t Height, uint8_t Width>
+const Bitboard<Height, Width>& Bitboard<Height, Width>::column(uint8_t x) {
+	static const auto columns { [] {
+		struct { Bitboard c[Width]; } cs {};
+		for (uint16_t i { 0 }; i < Cells; ++i) cs.c[i % Width].set(i);
+		return cs;
+	}() };
+	return columns.c[x];
+}
+
+
+// *** RowBitboard ***
+
+template <uint8_t Height, uint8_t Width>
+constexpr typename RowBitboard<Height, Width>::Row RowBitboard<Height, Width>::RowMask;
+
+template <uint8_t Height, uint8_t Width>
+uint16_t RowBitboard<Height, Width>::count() const {
+	uint16_t n { 0 };
+	for (uint8_t y { 0 }; y < Height; ++y) n += static_cast<uint16_t>(__builtin_popcountl(rows[y]));
+	return n;
+}
+
+template <uint8_t Height, uint8_t Width>
+bool RowBitboard<Height, Width>::any() const {
+	Row a { 0 };
+	for (uint8_t y { 0 }; y < Height; ++y) a |= rows[y];
+	return a != 0;
+}
+
+template <uint8_t Height, uint8_t Width>
+bool RowBitboard<Height, Width>::operator==(const RowBitboard& o) const {
+	Row d { 0 };
+	for (uint8_t y { 0 }; y < Height; ++y) d |= rows[y] ^ o.rows[y];
+	return d == 0;
+}
+
+template <uint8_t Height, uint8_t Width>
+RowBitboard<Height, Width> RowBitboard<Height, Width>::shifted(Direction d) const {
+	RowBitboard r;
+	switch (d) {
+		case Direction::UP: 	for (uint8_t y { 1 }; y < Height; ++y) r.rows[y - 1] = rows[y]; break;
+		case Direction::DOWN: 	for (uint8_t y { 1 }; y < Height; ++y) r.rows[y] = rows[y - 1]; break;
+		case Direction::LEFT: 	for (uint8_t y { 0 }; y < Height; ++y) r.rows[y] = static_cast<Row>(rows[y] >> 1); break;
+		case Direction::RIGHT: 	for (uint8_t y { 0 }; y < Height; ++y) r.rows[y] = static_cast<Row>((rows[y] << 1) & RowMask); break;
+		default: 				return *this;
+	}
+	return r;
+}
+
+template <uint8_t Height, uint8_t Width>
+RowBitboard<Height, Width> RowBitboard<Height, Width>::neighbours() const {
+	// One pass over the rows rather than four shifted copies.
+	RowBitboard r;
+	for (uint8_t y { 0 }; y < Height; ++y) {
+		Row n { static_cast<Row>(((rows[y] << 1) & RowMask) | (rows[y] >> 1)) };
+		if (y > 0) n |= rows[y - 1];
+		if (y + 1 < Height) n |= rows[y + 1];
+		r.rows[y] = n;
+	}
+	return r;
+}
+
+template <uint8_t Height, uint8_t Width>
+RowBitboard<Height, Width> RowBitboard<Height, Width>::reachable(const RowBitboard& free) const {
+	RowBitboard r { *this & free }, last;
+	do {
+		last = r;
+		r = (r | r.neighbours()) & free;
+	} while (r != last);
+	return r;
+}
+
+
+// *** BitboardGame ***
+
+template <uint8_t Height, uint8_t Width>
+BitboardGame<Height, Width> BitboardGame<Height, Width>::from(const GameCore& game) {
+
+	BitboardGame b {};
+	game.snake().forEachSegment([&b](const PointType& p) { b.snake.set(p); });
+	if (!game.snake().empty()) b.head.set(game.snake().head());
+	b.food.set(game.scran());
+	b.headPoint = game.snake().head();
+	b.tailPoint = game.snake().tail();
+	b.direction = game.direction();
+	return b;
+}
+
+template <uint8_t Height, uint8_t Width>
+bool BitboardGame<Height, Width>::matches(const GameCore& game) const {
+
+	for (uint8_t y { 0 }; y < Height; ++y) {
+		for (uint8_t x { 0 }; x < Width; ++x) {
+			const PointType p { y, x };
+			if (static_cast<bool>(game.snake().pointIsInside(p)) != snake.test(p)) return false;
+		}
+	}
+	return head.test(game.snake().head()) && head.count() == 1 &&
+		   food.test(game.scran()) && snake.count() == game.snake().length();
+}
+
+template <uint8_t Height, uint8_t Width>
+uint8_t BitboardGame<Height, Width>::safeMoves() const {
+
+	// Only one cell is asked about each way so test its bit rather than shift the board.
+	const uint16_t h { Board::index(headPoint) };
+	const uint16_t tail { Board::index(tailPoint) };
+	auto free { [&](uint16_t i) { return i == tail || !snake.test(i); } };
+
+	uint8_t moves { 0 };
+	if (headPoint.y > 0 && free(h - Width)) 			moves |= 1 << static_cast<uint8_t>(Direction::UP);
+	if (headPoint.x > 0 && free(h - 1)) 				moves |= 1 << static_cast<uint8_t>(Direction::LEFT);
+	if (headPoint.x + 1 < Width && free(h + 1)) 		moves |= 1 << static_cast<uint8_t>(Direction::RIGHT);
+	if (headPoint.y + 1 < Height && free(h + Width)) 	moves |= 1 << static_cast<uint8_t>(Direction::DOWN);
+
+	// Going back in to the neck is not a move.  The game carries on the way it was going.
+	if (direction != Direction::NONE && snake.count() > 1) moves &= ~(1 << static_cast<uint8_t>(~direction));
+	return moves;
+}
+
+template <uint8_t Height, uint8_t Width>
+uint16_t BitboardGame<Height, Width>::reachableAfter(Direction d) const {
+
+	if ((safeMoves() & (1 << static_cast<uint8_t>(d))) == 0) return 0;
+
+	Board free { ~snake };
+	free.set(tailPoint);
+	return head.shifted(d).reachable(free).count();
+}
+
+#endif // __BITBOARD_HPP_
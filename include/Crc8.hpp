@@ -0,0 +1,16 @@
+#ifndef __CRC8_HPP_
+#define __CRC8_HPP_
+
+#include <Arduino.h>
+
+namespace Utility {
+
+	// CRC-8 with the polynomial 0x07, one byte at a time.  Checks what is kept in the EEPROM.
+	inline uint8_t crc8(uint8_t crc, uint8_t byte) {
+		crc ^= byte;
+		for (uint8_t i { 0 }; i < 8; ++i) crc = static_cast<uint8_t>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+		return crc;
+	}
+}
+
+#endif // __CRC8_HPP_
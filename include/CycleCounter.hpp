@@ -0,0 +1,61 @@
+#ifndef __CYCLECOUNTER_HPP_
+#define __CYCLECOUNTER_HPP_
+
+#include <Arduino.h>
+
+// Cycle counter
+// Times short pieces of code in CPU cycles.  On the avr it reads Timer1, which ITimer1
+//	already runs for the buttons.  The timer counts up to OCR1A and starts again every
+//	1 ms so only times shorter than that are right.  The button interrupt is counted
+//	too if it goes off in the middle.  On the host there is no Timer1 so it takes
+//	micros() times 16, which is only good for rough numbers.
+//
+//		const CycleCounter timer {};
+//		doSomething();
+//		const uint16_t cycles { timer.cycles() };
+
+class CycleCounter {
+public:
+
+	CycleCounter() : m_start { now() } {}
+
+	// CPU cycles since it was made.
+	uint16_t cycles() const {
+#ifdef __AVR__
+		const uint16_t end { now() };
+		const uint16_t ticks { (end >= m_start) ? static_cast<uint16_t>(end - m_start)
+												: static_cast<uint16_t>(end + (OCR1A + 1) - m_start) };
+		return static_cast<uint16_t>(ticks * prescaler());
+#else
+		return static_cast<uint16_t>((now() - m_start) * 16);
+#endif
+	}
+
+#ifdef __AVR__
+	// CPU cycles for each count of the timer, from its clock select bits.
+	static uint16_t prescaler() {
+		switch (TCCR1B & 0x07) {
+			case 1: 	return 1;
+			case 2: 	return 8;
+			case 3: 	return 64;
+			case 4: 	return 256;
+			case 5: 	return 1024;
+			default: 	return 0;	// Stopped or clocked from a pin.
+		}
+	}
+#endif
+
+private:
+
+#ifdef __AVR__
+	static uint16_t now() { return TCNT1; }
+
+	const uint16_t m_start;
+#else
+	static unsigned long now() { return micros(); }
+
+	const unsigned long m_start;
+#endif
+};
+
+#endif // __CYCLECOUNTER_HPP_
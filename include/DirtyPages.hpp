@@ -0,0 +1,84 @@
+#ifndef __DIRTYPAGES_HPP_
+#define __DIRTYPAGES_HPP_
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include "globals.hpp"
+
+// Dirty pages
+// Sends only what has changed in the frame buffer to the display instead of all of it as
+//	display() does.  The SSD1306 keeps its memory as pages of 8 rows with a byte for each
+//	column, so the columns drawn on since the last flush are kept for each page and only
+//	those are sent.  Whatever draws calls mark() with the pixels it drew.
+//
+//	It counts the bytes it puts on the I2C bus, address bytes included.  display() puts
+//	fullScreenBytes on the bus each time.
+
+class DirtyPages {
+public:
+
+	static constexpr uint8_t Pages { Display::dspRect.height() / 8 };
+	static constexpr uint8_t Columns { Display::dspRect.width() };
+
+	// Commands to set the window and 1024 bytes in 34 transmissions.
+	static constexpr uint16_t fullScreenBytes { 1102 };
+
+	DirtyPages() { forget(); }
+
+	// The pixels x to x + w - 1 and y to y + h - 1 have changed.  Clipped to the screen.
+	void mark(int16_t x, int16_t y, int16_t w, int16_t h);
+	void markAll() { mark(0, 0, Columns, Pages * 8); }
+
+	/**
+	 * @brief Send the columns that have changed on each page to the display.
+	 * @param display The display whose buffer was drawn on.
+	 */
+	void flush(Adafruit_SSD1306& display);
+
+	// Bytes put on the bus since the last call.
+	uint32_t takeBytes() { const uint32_t b { m_bytes }; m_bytes = 0; return b; }
+
+private:
+
+	void forget();
+
+	uint8_t m_first[Pages];		// First column changed on each page.  Columns if none.
+	uint8_t m_last[Pages];		// Last column changed.
+	uint32_t m_bytes { 0 };
+};
+
+
+// Save under
+// The frame buffer under a box kept before something is drawn over it and put back byte
+//	for byte after, instead of drawing what was there again.  Whole pages are kept so the
+//	box does not have to start or end on a page.  Putting them back costs the same
+//	whatever was under the box and marks only those columns for the next flush.
+template <uint8_t X, uint8_t Y, uint8_t W, uint8_t H>
+class SaveUnder {
+public:
+
+	static constexpr uint8_t FirstPage { Y / 8 };
+	static constexpr uint8_t LastPage { (Y + H - 1) / 8 };
+	static constexpr uint16_t Size { (LastPage - FirstPage + 1) * W };
+
+	static_assert(X + W <= DirtyPages::Columns && LastPage < DirtyPages::Pages, "The box is off the screen.");
+
+	void save(Adafruit_SSD1306& display) {
+		const uint8_t* buffer { display.getBuffer() };
+		for (uint8_t page { FirstPage }; page <= LastPage; ++page)
+			memcpy(m_bytes + (page - FirstPage) * W, buffer + page * DirtyPages::Columns + X, W);
+	}
+
+	void restore(Adafruit_SSD1306& display, DirtyPages& dirty) const {
+		uint8_t* buffer { display.getBuffer() };
+		for (uint8_t page { FirstPage }; page <= LastPage; ++page)
+			memcpy(buffer + page * DirtyPages::Columns + X, m_bytes + (page - FirstPage) * W, W);
+		dirty.mark(X, FirstPage * 8, W, (LastPage - FirstPage + 1) * 8);
+	}
+
+private:
+
+	uint8_t m_bytes[Size];
+};
+
+#endif // __DIRTYPAGES_HPP_
@@ -0,0 +1,27 @@
+#ifndef __EEPROMLAYOUT_HPP_
+#define __EEPROMLAYOUT_HPP_
+
+#include <Arduino.h>
+
+// Where everything is kept in the 1 KB of EEPROM.  Keep these from overlapping.
+namespace EepromLayout {
+
+	constexpr uint16_t size { 1024 };
+
+	constexpr uint16_t highScore { 0 };		// 1 byte.  The high score / 10 from before the table.
+
+	constexpr uint16_t highScores { 16 };	// The high score table.  See HighScores.hpp.
+	constexpr uint16_t highScoresSize { 688 };
+
+	constexpr uint16_t snapshot { 704 };	// The game saved when it was paused.  See Snapshot.hpp.
+	constexpr uint16_t snapshotSize { 64 };
+
+	constexpr uint16_t replay { 768 };		// The replay of the last game.
+	constexpr uint16_t replaySize { 256 };
+
+	static_assert(highScores + highScoresSize <= snapshot, "The high score table overlaps the snapshot.");
+	static_assert(snapshot + snapshotSize <= replay, "The snapshot overlaps the replay.");
+	static_assert(replay + replaySize <= size, "Replay does not fit in the EEPROM.");
+}
+
+#endif // __EEPROMLAYOUT_HPP_
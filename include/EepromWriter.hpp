@@ -0,0 +1,50 @@
+#ifndef __EEPROMWRITER_HPP_
+#define __EEPROMWRITER_HPP_
+
+#include <Arduino.h>
+
+// EEPROM writer
+// Writes to the EEPROM in the background.  A byte takes about 3.3 ms to write and
+//	EEPROM.write() waits for each one, so instead bytes go in a queue that the EEPROM
+//	ready interrupt empties a byte at a time while the game goes on.  Like EEPROM.update()
+//	a byte that already holds the value is not written, which the interrupt checks just
+//	before writing it.  Writing a byte that is still in the queue drops the old value and
+//	queues the new one at the back, so bytes are written in the order of the last
+//	update() of each.  update() only waits when the queue is full.
+//
+//	Everything that reads or writes the EEPROM goes through here, as EEPROM.read() is
+//	not safe while the interrupt is writing.  On the host there is no interrupt and
+//	bytes are written at once.
+
+namespace EepromWriter {
+
+	constexpr uint8_t Depth { 32 };		// Bytes the queue holds.  A power of 2.
+
+	/**
+	 * @brief Write a byte in the background unless it already holds the value.
+	 * @param address The address in the EEPROM.
+	 * @param value The value to write.
+	 */
+	void update(uint16_t address, uint8_t value);
+
+	// The byte at address as it will be once the queue has been written.  Waits for a
+	//	byte being written.
+	uint8_t read(uint16_t address);
+
+	// Wait until everything queued has been written.
+	void flush();
+
+	// Nothing is queued or being written.
+	bool idle();
+
+	// For the debug output.
+	struct Counters {
+		uint16_t queued { 0 };		// Bytes put in the queue.
+		uint16_t skipped { 0 };		// Bytes that held the value already or replaced a queued one.
+		uint8_t deepest { 0 };		// The most bytes there have been in the queue.
+		uint32_t stall_us { 0 };	// Time update(), read() and flush() have waited.
+	};
+	const Counters& counters();
+}
+
+#endif // __EEPROMWRITER_HPP_
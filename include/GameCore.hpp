@@ -0,0 +1,142 @@
+#ifndef __GAMECORE_HPP_
+#define __GAMECORE_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "Snake.hpp"
+#include "Random.hpp"
+#include "Levels.hpp"
+
+// GameCore
+// The rules of the game with nothing to do with the display, sound or timing.  One
+//	call to step() is one tick of the game and returns what happened so that the caller
+//	can draw it and play sounds.  All of the state is in here, including the random
+//	numbers, so a game is decided by its seed and the directions it is given.  On a PC
+//	it runs millions of steps a second which the host tools use.
+
+
+using SnakeType = Snake<SNAKE_DATA_SIZE, PointType>;
+
+
+// What happened in one step.
+struct GameEvents {
+
+	enum : uint8_t {
+		Moved 	= 0x01, 	// The head moved to head.
+		Ate 	= 0x02, 	// The scran was eaten and a new one placed.
+		SpeedUp = 0x04, 	// The update time went down.
+		HitWall = 0x08, 	// Tried to leave the world or go into a wall.  Nothing moved.
+		HitSelf = 0x10, 	// Tried to move into the snake.  Nothing moved.
+		Won 	= 0x20		// Ate the last scran.  The snake fills the world.
+	};
+
+	uint8_t flags { 0 };
+	PointType head {}; 			// Where the head is now if Moved.
+	PointType removedTail {}; 	// The cell the tail left if Moved and not Ate.
+
+	bool has(uint8_t flag) const { return (flags & flag) != 0; }
+	bool gameOver() const { return has(HitWall | HitSelf | Won); }
+};
+
+
+class GameCore {
+public:
+
+	// The rules.
+	static constexpr uint16_t updateTimeOnReset_ms { 300 };	// Time between steps at the start.
+	static constexpr uint8_t scranScore { 10 };				// Points for eating.
+	static constexpr uint16_t speedUpEvery { 100 };			// Points between speed ups.
+	static constexpr uint8_t speedUpDivisor { 10 };			// A speed up takes 1/this off the update time.
+
+	/**
+	 * @brief Start a new game.  A one segment snake at a random point, no score and scran placed.
+	 * @param seed Seeds the random numbers.  The same seed and inputs give the same game.
+	 * @param level Which of the Levels.  0 is the open world.
+	 */
+	void reset(uint32_t seed, uint8_t level = 0);
+
+	/**
+	 * @brief Run one tick of the game.
+	 * @param input The last direction pressed.  Ignored if the same, the opposite or not a direction.
+	 * @return What happened.
+	 */
+	GameEvents step(Direction input);
+
+	const SnakeType& snake() const { return m_snake; }
+	const PointType& scran() const { return m_scran; }
+	ScoreType score() const { return m_score; }
+	uint16_t updateTime_ms() const { return m_updateTime_ms; }
+	Direction direction() const { return m_snake.getDirection(); }
+	const Random& random() const { return m_random; }
+	uint8_t level() const { return m_level; }
+
+	// A byte that mixes all of the state.  Two games that have gone differently will
+	//	almost always have different checksums.  Replays use it to check they match.
+	uint8_t checksum() const;
+
+	// For tools and saved games that need to start from a particular position.
+	void setSnake(const SnakeType& snake) { m_snake = snake; }
+	void setScran(const PointType& scran) { m_scran = scran; }
+	void setScore(ScoreType score) { m_score = score; }
+	void setUpdateTime_ms(uint16_t time) { m_updateTime_ms = time; }
+	void setRandom(const Random& random) { m_random = random; }
+	void setLevel(uint8_t level);
+
+	/**
+	 * @brief Check if moving would take the player out of the game area.  Checked before
+	 *  the move as a packed point wraps at the edges rather than going out of the area.
+	 * @param head Where the head is now.
+	 * @param direction The way it is going.
+	 * @return true if the move leaves the area else false.
+	 */
+	bool detectPlayerOutOfArea(const PointType& head, Direction direction) const;
+
+	/**
+	 * @brief Check if the player collided with himself.  The tail does not count as it moves away.
+	 * @param newHead A point describing where the new head will be.
+	 * @return true if a collision is deteced else false.
+	 */
+	bool detectSelfCollision(const PointType& newHead) const;
+
+	// p is one of the level's walls.  One read of flash.
+	bool detectWall(const PointType& p) const { return m_walls != nullptr && Levels::wall(m_walls, p); }
+
+private:
+	/**
+	 * @brief Check if food eaten.
+	 * @return true if yes.
+	 */
+	bool detectPlayerAteScran() const { return m_snake.head() == m_scran; }
+
+	/**
+	 * @brief Place food at a random location not in the snake.
+	 * @return false if there is nowhere left to put it.
+	 */
+	bool placeRandomScran();
+
+	PointType getRandomPoint();
+
+	SnakeType m_snake {};
+	PointType m_scran {};
+	ScoreType m_score { 0 };
+	uint16_t m_updateTime_ms { updateTimeOnReset_ms };
+	Random m_random {};
+	uint8_t m_level { 0 };
+	const uint8_t* m_walls { nullptr };		// The level's map in flash.
+};
+
+
+// The point next to p in direction d.  Any kind of point.
+template <typename PointT>
+inline PointT movePoint(const PointT& p, Direction d) {
+	using DataT = decltype(PointT::y);
+	switch (d) {
+		case Direction::UP: 	return { static_cast<DataT>(p.y - 1), p.x };
+		case Direction::DOWN: 	return { static_cast<DataT>(p.y + 1), p.x };
+		case Direction::LEFT: 	return { p.y, static_cast<DataT>(p.x - 1) };
+		case Direction::RIGHT: 	return { p.y, static_cast<DataT>(p.x + 1) };
+		default: 				return p;
+	}
+}
+
+#endif // __GAMECORE_HPP_
@@ -3,7 +3,7 @@
 
 // Geometry Header
 // Header only library containing definition of Point and it's alias Size.
-// 	as well as Rectangle.
+// 	as well as Rectangle.  Point<Packed<YBits>> is a Point kept in a single byte.
 
 
 #include <Arduino.h>
@@ -22,6 +22,13 @@ struct is_unsigned {
 	static constexpr bool value { (T(-1) > T(0)) };
 };
 
+// Picks A if Small else B.  The same as std::conditional which the avr does not have.
+template <bool Small, typename A, typename B> struct SelectType { using type = A; };
+template <typename A, typename B> struct SelectType<false, A, B> { using type = B; };
+
+// The number of bits needed to hold 0 to n - 1.
+constexpr uint8_t bitsFor(unsigned long n) { return (n <= 1) ? 0 : 1 + bitsFor((n + 1) / 2); }
+
 }
 
 
@@ -64,6 +71,49 @@ size_t printTo(Print& p) const {
 };
 
 
+// A point packed in to one byte with YBits for the row and the rest for the column.
+//	Reads and writes of y and x are the same as any Point so it can be used in place of
+//	one, but == is one compare of the byte and += / -= are one add.  There is nothing
+//	between the two coordinates so one that goes past its bits carries in to the other
+//	and the top row wraps to the bottom.  Check a move against the edges before making it.
+template <uint8_t YBits>
+struct Packed {};
+
+template <uint8_t YBits>
+struct Point<Packed<YBits>>
+#if (DEBUG == YES)
+: public Printable
+#endif
+{
+	static_assert(YBits > 0 && YBits < 8, "Both coordinates need at least one bit.");
+	static constexpr uint8_t XBits { 8 - YBits };
+
+	constexpr Point() : x{0}, y{0} {}
+	constexpr Point(uint8_t y, uint8_t x) : x{x}, y{y} {}
+
+	template <typename OtherPointDataType>
+	constexpr Point(const Point<OtherPointDataType>& other) : x(other.x), y(other.y) {}
+
+	// The Coordinates.  x is first so it is in the low bits.
+	uint8_t x : XBits;
+	uint8_t y : YBits;
+
+	// Both coordinates as one byte.  The compiler turns this in to a load of the byte.
+	constexpr uint8_t raw() const { return static_cast<uint8_t>((y << XBits) | x); }
+	constexpr void setRaw(uint8_t r) { x = r & ((1 << XBits) - 1); y = r >> XBits; }
+
+	constexpr bool operator==(const Point& other) const { return raw() == other.raw(); }
+	constexpr bool operator!=(const Point& other) const { return !(*this == other); }
+	// The deltas used are { 1, 0 } and { 0, 1 } which only fit unpacked.
+	constexpr void operator+=(const Point<uint8_t>& other) { setRaw(raw() + static_cast<uint8_t>((other.y << XBits) + other.x)); }
+	constexpr void operator-=(const Point<uint8_t>& other) { setRaw(raw() - static_cast<uint8_t>((other.y << XBits) + other.x)); }
+
+#if (DEBUG == YES)
+size_t printTo(Print& p) const { return Point<uint8_t>{ *this }.printTo(p); }
+#endif
+};
+
+
 template <typename T> using Size = Point<T>;
 
 template <typename PointT, typename DataT = decltype(PointT::x)>
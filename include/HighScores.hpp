@@ -0,0 +1,52 @@
+#ifndef __HIGHSCORES_HPP_
+#define __HIGHSCORES_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+
+// High scores
+// The best few scores in full kept in the EEPROM.  Each time the table changes the whole
+//	of it is written as a new record to the next slot of a ring, so each cell is written
+//	once every Slots changes rather than every time.
+//
+//	Record, recordSize bytes:
+//		sequence					2 bytes, little endian.  One more than the record before,
+//									0xFFFF is never used as that is an erased cell.
+//		scores						2 bytes each, little endian, best first.
+//		CRC-8 of the above			1 byte
+//
+//	Records are written from slot 0 up and round again, so the sequence carries on by one
+//	a slot from slot 0 to the latest.  load() finds the latest with a binary search on
+//	that, reading a few sequences rather than the whole ring.  A record cut off by the
+//	power going fails its CRC and the one before is used.  Only an erased ring, or slot 0
+//	failing, needs every slot read.
+//
+//	The high score / 10 in the byte at EepromLayout::highScore from before the table is
+//	moved into it the first time.
+
+namespace HighScores {
+
+	constexpr uint8_t Entries { 5 };
+	constexpr uint8_t recordSize { 2 + 2 * Entries + 1 };
+
+	/**
+	 * @brief Find the latest table in the EEPROM.  Call once from setup().
+	 */
+	void load();
+
+	// The score in place 0 to Entries - 1, 0 for an empty place.
+	uint16_t score(uint8_t place);
+	inline uint16_t best() { return score(0); }
+
+	/**
+	 * @brief Put a score in the table if it is better than one there and save the table.
+	 * @param score The score.
+	 * @return Its place or Entries if it is not in the table.
+	 */
+	uint8_t add(uint16_t score);
+
+	// Empty the table and save it.
+	void clear();
+}
+
+#endif // __HIGHSCORES_HPP_
@@ -0,0 +1,69 @@
+#ifndef __LEVELS_HPP_
+#define __LEVELS_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+
+// Levels
+// Walls inside the world as well as round it.  Each level is a map of the screen sized
+//	world with a bit for each cell, 1 for a wall, kept in flash so levels cost no RAM.
+//	The maps are made by tools/make_levels.py from the text and PBM files in levels/
+//	and are in src/LevelData.cpp, which is not edited by hand.
+//
+//	A row of the map is RowBytes bytes, column x in bit x % 8 of byte x / 8, so a wall
+//	check is one pgm_read_byte and a mask.  With each map is a table of the free cells
+//	before each row so the n-th free cell is found by walking the rows and then one row
+//	rather than picking cells until one is free.
+//
+//	Level 0 is the open world with no map and games on it go exactly as they did before
+//	there were levels.  Large board builds only have level 0.
+
+namespace Levels {
+
+	constexpr uint8_t Height { World::ScreenWorld.height() };
+	constexpr uint8_t Width { World::ScreenWorld.width() };
+	constexpr uint8_t RowBytes { (Width + 7) / 8 };
+	constexpr uint16_t Cells { static_cast<uint16_t>(Height * Width) };
+
+	static_assert(Cells <= 255, "The free cell counts are kept in a byte.");
+
+	// In flash.  Read with the functions below.
+	struct Level {
+		const uint8_t* walls;		// Height * RowBytes bytes, or nullptr for none.
+		const uint8_t* rows;		// The free cells before each row.
+		uint8_t freeCells;
+		const char* name;
+	};
+
+	// Made by tools/make_levels.py.
+	extern const Level table[] PROGMEM;
+	extern const uint8_t count;
+
+	// The map of a level in flash, or nullptr if it has no walls.
+	inline const uint8_t* walls(uint8_t level) {
+		return static_cast<const uint8_t*>(pgm_read_ptr(&table[level].walls));
+	}
+
+	// The cell is a wall.  walls is from walls() and not nullptr.
+	template <typename PointT>
+	inline bool wall(const uint8_t* walls, const PointT& p) {
+		return (pgm_read_byte(walls + p.y * RowBytes + (p.x >> 3)) >> (p.x & 7)) & 1;
+	}
+
+	inline uint8_t freeCells(uint8_t level) { return pgm_read_byte(&table[level].freeCells); }
+
+	// The name in flash, for print().
+	inline const __FlashStringHelper* name(uint8_t level) {
+		return reinterpret_cast<const __FlashStringHelper*>(pgm_read_ptr(&table[level].name));
+	}
+
+	/**
+	 * @brief Find a free cell of a level without trying cells at random.
+	 * @param level A level with walls.
+	 * @param n Which free cell, 0 to freeCells(level) - 1, counting along the rows.
+	 * @return The cell.
+	 */
+	PointType freeCell(uint8_t level, uint8_t n);
+}
+
+#endif // __LEVELS_HPP_
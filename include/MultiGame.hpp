@@ -0,0 +1,243 @@
+#ifndef __MULTIGAME_HPP_
+#define __MULTIGAME_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "GameCore.hpp"
+#include "Bitboard.hpp"
+
+// MultiGame
+// Snakes sharing the screen sized world, each steered by its own input so any of them
+//	can be a player or an AI.  Which cells any snake is in is kept in one occupancy
+//	bitboard, set as heads are pushed and cleared as tails are popped, so running into
+//	any snake is one bit test instead of walking every snake's crumb ring.  A tick costs
+//	a push, a pop and a few bit operations for each snake whatever their lengths.
+//
+//	The crumb rings are an array in the game with each snake getting an equal share of
+//	what one snake filling the world needs, so N snakes take the same RAM as one.  A snake
+//	stops growing one short of its ring being full, as a move pushes before it pops.
+//
+//	In a tick all of the snakes move at once:
+//		Each turns to its input as in GameCore.  One with no direction yet waits.
+//		One that would leave the world, move into any snake, meet another head on or swap
+//		cells with another head dies.
+//		A tail that leaves in this tick can be moved into, as in GameCore.
+//		The dead are taken off the world.  The game is over when none are left.
+//		The one that eats scores and the scran is put somewhere free.
+//	Speed ups go by the scores of all of the snakes added up.
+
+template <uint8_t Snakes>
+class MultiGame {
+public:
+
+	static constexpr uint8_t Height { World::ScreenWorld.height() };
+	static constexpr uint8_t Width { World::ScreenWorld.width() };
+	static constexpr uint16_t Cells { static_cast<uint16_t>(Height * Width) };
+
+	// Each snake's share of the crumbs.
+	static constexpr SnakeDataSizeType ShareSize { static_cast<SnakeDataSizeType>((Cells + 4 * Snakes - 1) / (4 * Snakes)) };
+
+	using Body = Snake<ShareSize, PointType>;
+	using Board = RowBitboard<Height, Width>;
+
+	static_assert(Snakes >= 1 && Snakes <= 8, "One to eight snakes.");
+
+	/**
+	 * @brief Start a new game.  One segment snakes at random free cells, not moving, no scores.
+	 * @param seed Seeds the random numbers.  The same seed and inputs give the same game.
+	 */
+	void reset(uint32_t seed);
+
+	/**
+	 * @brief Run one tick of the game for every snake.
+	 * @param inputs The last direction given to each snake.  Ignored for the dead.
+	 * @param events What happened to each snake.  HitSelf is running into any snake.
+	 */
+	void step(const Direction (&inputs)[Snakes], GameEvents (&events)[Snakes]);
+
+	const Body& snake(uint8_t i) const { return m_snakes[i]; }
+	bool alive(uint8_t i) const { return (m_alive >> i) & 1; }
+	uint8_t left() const;							// Snakes alive.
+	ScoreType score(uint8_t i) const { return m_scores[i]; }
+	const PointType& scran() const { return m_scran; }
+	uint16_t updateTime_ms() const { return m_updateTime_ms; }
+
+	// Any snake is in p.
+	bool taken(const PointType& p) const { return m_taken.test(p); }
+
+	// The occupancy grid has exactly the cells of the live snakes.  For tests.
+	bool consistent() const;
+
+	// Moving in d from p would leave the world.
+	static bool leaves(const PointType& p, Direction d) {
+		switch (d) {
+			case Direction::UP: 	return p.y == 0;
+			case Direction::DOWN: 	return p.y + 1 >= Height;
+			case Direction::LEFT: 	return p.x == 0;
+			case Direction::RIGHT: 	return p.x + 1 >= Width;
+			default: 				return false;
+		}
+	}
+
+private:
+
+	PointType randomFreeCell();
+	void remove(uint8_t i);
+
+	Body m_snakes[Snakes] {};
+	Board m_taken {};
+	uint8_t m_alive { 0 };
+	ScoreType m_scores[Snakes] {};
+	PointType m_scran {};
+	uint16_t m_updateTime_ms { GameCore::updateTimeOnReset_ms };
+	ScoreType m_total { 0 };
+	Random m_random {};
+};
+
+
+template <uint8_t Snakes>
+void MultiGame<Snakes>::reset(uint32_t seed) {
+
+	m_random = Random { seed };
+	m_taken = Board {};
+	m_alive = static_cast<uint8_t>((1u << Snakes) - 1);
+	m_total = 0;
+	m_updateTime_ms = GameCore::updateTimeOnReset_ms;
+
+	for (uint8_t i { 0 }; i < Snakes; ++i) {
+		m_snakes[i] = Body {};
+		const PointType p { randomFreeCell() };
+		m_snakes[i].push(p);
+		m_taken.set(p);
+		m_scores[i] = 0;
+	}
+	m_scran = randomFreeCell();
+}
+
+
+template <uint8_t Snakes>
+void MultiGame<Snakes>::step(const Direction (&inputs)[Snakes], GameEvents (&events)[Snakes]) {
+
+	PointType heads[Snakes] {};
+	uint8_t moving { 0 }, dying { 0 }, eating { 0 }, growing { 0 };
+
+// 1. - Turn and find the new heads.  Walls kill.
+	for (uint8_t i { 0 }; i < Snakes; ++i) {
+		events[i] = GameEvents {};
+		if (!alive(i)) continue;
+
+		Body& s { m_snakes[i] };
+		const Direction input { inputs[i] };
+		if (input <= Direction::DOWN && input != s.getDirection() && input != ~s.getDirection())
+			s.setDirection(input);
+		if (s.getDirection() == Direction::NONE) continue;
+
+		if (leaves(s.head(), s.getDirection())) {
+			events[i].flags |= GameEvents::HitWall;
+			dying |= 1 << i;
+			continue;
+		}
+		heads[i] = movePoint(s.head(), s.getDirection());
+		moving |= 1 << i;
+		if (heads[i] == m_scran) {
+			eating |= 1 << i;
+			if (s.length() + 1 < s.capacity()) growing |= 1 << i;	// Room for the push before the pop.
+		}
+	}
+
+// 2. - Tails that leave this tick are free to move into.
+	for (uint8_t i { 0 }; i < Snakes; ++i)
+		if (((moving & ~growing) >> i) & 1) m_taken.reset(m_snakes[i].tail());
+
+// 3. - Into any snake, or head on into another head, kills.  So does swapping cells with
+//	another head, which step 2 lets one segment snakes do as their tails are their heads.
+	for (uint8_t i { 0 }; i < Snakes; ++i) {
+		if (!((moving >> i) & 1)) continue;
+		bool hit { m_taken.test(heads[i]) };
+		for (uint8_t j { 0 }; j < Snakes; ++j) {
+			if (j == i || !((moving >> j) & 1)) continue;
+			if (heads[j] == heads[i] || (heads[i] == m_snakes[j].head() && heads[j] == m_snakes[i].head())) hit = true;
+		}
+		if (hit) {
+			events[i].flags |= GameEvents::HitSelf;
+			dying |= 1 << i;
+		}
+	}
+
+// 4. - Take the dead off the world before any new head is put on it.
+	for (uint8_t i { 0 }; i < Snakes; ++i) if ((dying >> i) & 1) remove(i);
+
+// 5. - Move the rest.
+	bool ate { false };
+	for (uint8_t i { 0 }; i < Snakes; ++i) {
+		if (!(((moving & ~dying) >> i) & 1)) continue;
+
+		Body& s { m_snakes[i] };
+		s.push(heads[i]);
+		m_taken.set(heads[i]);
+		events[i].flags |= GameEvents::Moved;
+		events[i].head = heads[i];
+
+		if ((eating >> i) & 1) {
+			events[i].flags |= GameEvents::Ate;
+			m_scores[i] += GameCore::scranScore;
+			m_total += GameCore::scranScore;
+			if (m_total % GameCore::speedUpEvery == 0) {
+				m_updateTime_ms -= (m_updateTime_ms / GameCore::speedUpDivisor);
+				events[i].flags |= GameEvents::SpeedUp;
+			}
+			ate = true;
+		}
+		// A full snake that eats keeps its length.
+		if (!((growing >> i) & 1)) events[i].removedTail = s.pop();
+	}
+
+	if (ate) {
+		uint16_t taken { 0 };
+		for (uint8_t i { 0 }; i < Snakes; ++i) if (alive(i)) taken += m_snakes[i].length();
+		if (taken < Cells) m_scran = randomFreeCell();
+		else for (uint8_t i { 0 }; i < Snakes; ++i) if (events[i].has(GameEvents::Ate)) events[i].flags |= GameEvents::Won;
+	}
+}
+
+
+template <uint8_t Snakes>
+uint8_t MultiGame<Snakes>::left() const {
+	uint8_t n { 0 };
+	for (uint8_t i { 0 }; i < Snakes; ++i) n += alive(i);
+	return n;
+}
+
+
+template <uint8_t Snakes>
+bool MultiGame<Snakes>::consistent() const {
+	Board b {};
+	uint16_t segments { 0 };
+	for (uint8_t i { 0 }; i < Snakes; ++i) {
+		if (!alive(i)) continue;
+		m_snakes[i].forEachSegment([&b](const PointType& p) { b.set(p); });
+		segments += m_snakes[i].length();
+	}
+	// A count short of the segments is two of them in one cell.
+	return b == m_taken && b.count() == segments;
+}
+
+
+// Only called with a free cell left.
+template <uint8_t Snakes>
+PointType MultiGame<Snakes>::randomFreeCell() {
+	PointType p {};
+	do {
+		p = { static_cast<POINT_DATA_TYPE>(m_random.below(Height)), static_cast<POINT_DATA_TYPE>(m_random.below(Width)) };
+	} while (m_taken.test(p));
+	return p;
+}
+
+
+template <uint8_t Snakes>
+void MultiGame<Snakes>::remove(uint8_t i) {
+	m_snakes[i].forEachSegment([this](const PointType& p) { m_taken.reset(p); });
+	m_alive &= static_cast<uint8_t>(~(1u << i));
+}
+
+#endif // __MULTIGAME_HPP_
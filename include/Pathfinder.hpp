@@ -0,0 +1,138 @@
+#ifndef __PATHFINDER_HPP_
+#define __PATHFINDER_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "GameCore.hpp"
+#include "Bitboard.hpp"
+
+// Pathfinder
+// Searches for the AI: the shortest way to the scran and how much room a move leaves.
+//	Both are breadth first searches done on whole bitboards, each step of the search is
+//	a few shifts and masks of every cell at once rather than a queue of cells.
+//
+//	The snake moves while the head does.  Segment i counted from the tail has gone after
+//	i + 1 moves so a search at step t can go through the cells of the first t segments.
+//	Snake::Walker gives them in that order.  A shortest path never crosses itself so the
+//	distance it finds is exact as long as nothing is eaten on the way.
+//
+//	Board is Bitboard (64-bit words, for the host) or RowBitboard (a word a row, for the
+//	avr).  WorldPathfinder picks the one for where it is built.
+
+template <typename Board>
+class Pathfinder {
+public:
+
+	struct Path {
+		uint16_t length { 0 };					// Moves to the scran.  0 if it cannot be reached.
+		Direction first { Direction::NONE }; 	// The first of them.
+		bool found() const { return length != 0; }
+	};
+
+	/**
+	 * @brief The shortest way to the scran.  Ties go to UP, LEFT, RIGHT then DOWN.
+	 * @param game The game.
+	 * @return The length of the path and its first move.
+	 */
+	static Path toScran(const GameCore& game);
+
+	/**
+	 * @brief How many cells the head could get to after moving in d.  Cells of the snake
+	 *  count once the tail has left them.  The head is taken to be able to wait for them
+	 *  which it cannot so this is the most there could be.
+	 * @return The number of cells or 0 if the move ends the game.
+	 */
+	static uint16_t reachableAfter(const GameCore& game, Direction d);
+
+private:
+
+	// The moves step() will take.  Not back the way it came.
+	static bool canTurn(const GameCore& game, Direction d) {
+		return game.direction() == Direction::NONE || d != ~game.direction();
+	}
+
+	static Board snakeBoard(const GameCore& game) {
+		Board b {};
+		game.snake().forEachSegment([&b](const PointType& p) { b.set(p); });
+		return b;
+	}
+
+	// The next cell the tail leaves becomes free.
+	static void vacate(Board& free, SnakeType::Walker& tail) {
+		if (tail.done()) return;
+		free.set(tail.point());
+		tail.next();
+	}
+};
+
+#ifdef __AVR__
+using WorldPathfinder = Pathfinder<RowBitboard<World::ScreenWorld.height(), World::ScreenWorld.width()>>;
+#else
+using WorldPathfinder = Pathfinder<WorldBitboard>;
+#endif
+
+
+template <typename Board>
+typename Pathfinder<Board>::Path Pathfinder<Board>::toScran(const GameCore& game) {
+
+	constexpr Direction directions[] { Direction::UP, Direction::LEFT, Direction::RIGHT, Direction::DOWN };
+
+	Board free { ~snakeBoard(game) };
+	SnakeType::Walker tail { game.snake() };
+	Board scran {}, start {};
+	scran.set(game.scran());
+	start.set(game.snake().head());
+
+	// One frontier for each first move so the move that got to the scran is known.
+	//	A cell reached by two at once goes to the first.
+	Board frontier[4] {}, visited { start };
+	vacate(free, tail);
+	for (uint8_t i { 0 }; i < 4; ++i)
+		if (canTurn(game, directions[i])) frontier[i] = start.shifted(directions[i]) & free;
+
+	for (uint16_t t { 1 }; ; ++t) {
+
+		bool any { false };
+		for (uint8_t i { 0 }; i < 4; ++i) {
+			if ((frontier[i] & scran).any()) return { t, directions[i] };
+			visited = visited | frontier[i];
+			any = any || frontier[i].any();
+		}
+		if (!any) return {};
+
+		vacate(free, tail);
+		const Board open { free & ~visited };
+		Board taken {};
+		for (uint8_t i { 0 }; i < 4; ++i) {
+			frontier[i] = frontier[i].neighbours() & open & ~taken;
+			taken = taken | frontier[i];
+		}
+	}
+}
+
+template <typename Board>
+uint16_t Pathfinder<Board>::reachableAfter(const GameCore& game, Direction d) {
+
+	if (!canTurn(game, d) || game.detectPlayerOutOfArea(game.snake().head(), d)) return 0;
+
+	Board free { ~snakeBoard(game) };
+	SnakeType::Walker tail { game.snake() };
+	vacate(free, tail);
+
+	Board region {};
+	region.set(movePoint(game.snake().head(), d));
+	region = region & free;
+	if (!region.any()) return 0;
+
+	// Grow a step and free a segment each time round.  Stop when it has stopped growing
+	//	and none of the snake left is next to it to open up later.
+	for (;;) {
+		vacate(free, tail);
+		const Board next { (region | region.neighbours()) & free };
+		if (next == region && (tail.done() || !(region.neighbours() & ~free).any())) break;
+		region = next;
+	}
+	return region.count();
+}
+
+#endif // __PATHFINDER_HPP_
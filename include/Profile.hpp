@@ -0,0 +1,75 @@
+#ifndef __PROFILE_HPP_
+#define __PROFILE_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+
+// Profile
+// How long the main parts of the game take on a real unit.  PROFILE_ZONE(id) at the top
+//	of a block times the block from there to its end and adds it to the zone's count,
+//	least, most and total in a table in RAM.  Zones can be inside each other and
+//	ReadButtons is timed in its interrupt, which is also counted in any zone it goes off
+//	in the middle of.
+//
+//	Times are CPU cycles from Timer1, which ITimer1 runs for the buttons, and the count
+//	of its 1 ms interrupts, so unlike CycleCounter a zone can take longer than 1 ms.  On
+//	the host it is micros() times 16.
+//
+//	command('P') sends the table over serial, a zone a line each time round the loop
+//	so it never waits, and command('R') empties it.  With PROFILE off PROFILE_ZONE()
+//	and the rest are nothing.
+
+namespace Profile {
+
+	enum class Zone : uint8_t {
+		UpdateGame, DrawSnake, Display, PlaceScran, ReadButtons, GameOver, Demo,
+		Flash, Boxes, Wipe, HighScore,		// A frame of each animation, without its delay().
+		Count
+	};
+
+#if (PROFILE == YES)
+	struct Stats {
+		uint16_t count;
+		uint32_t least, most, total;		// Cycles.
+	};
+
+	// Cycles since the start.  Goes round every 268 s at 16 MHz.
+	uint32_t now();
+
+	// Count a zone.  If the total would go round, it and the count are halved.
+	void add(Zone zone, uint32_t cycles);
+
+	// The 1 ms Timer1 interrupt has gone off.  Call first thing in it.
+	void timerTick();
+
+	// Times from where it is made to the end of the block.
+	class Scope {
+		const Zone m_zone;
+		const uint32_t m_start;
+	public:
+		explicit Scope(Zone zone) : m_zone{ zone }, m_start{ now() } {}
+		~Scope() { add(m_zone, now() - m_start); }
+	};
+
+	/**
+	 * @brief A command read from serial.  'P' sends the table and 'R' empties it.
+	 * @param c The character.
+	 */
+	void command(char c);
+
+	// Send the next line of the table if there is one and room for it.  Call each time round the loop.
+	void poll();
+#else
+	inline void timerTick() {}
+	inline void command(char) {}
+	inline void poll() {}
+#endif
+}
+
+#if (PROFILE == YES)
+	#define PROFILE_ZONE(id) 	const Profile::Scope profileZone_##id { Profile::Zone::id }
+#else
+	#define PROFILE_ZONE(id)
+#endif
+
+#endif // __PROFILE_HPP_
@@ -0,0 +1,29 @@
+#ifndef __RANDOM_HPP_
+#define __RANDOM_HPP_
+
+#include <Arduino.h>
+
+// A small random number generator (xorshift32).
+// The game owns one of these rather than using Arduino's random() so that a game only
+//	depends on its seed.  Replays, saved games and the host tools rely on that.
+struct Random {
+
+	uint32_t state;
+
+	constexpr Random(uint32_t seed = 1) : state{ (seed != 0) ? seed : static_cast<uint32_t>(0x2545F491UL) } {}
+
+	uint32_t next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	// A number from 0 to n - 1.  Scales the top 16 bits instead of dividing which
+	//	is slow on the AVR.
+	uint16_t below(uint16_t n) {
+		return static_cast<uint16_t>((static_cast<uint32_t>(next() >> 16) * n) >> 16);
+	}
+};
+
+#endif // __RANDOM_HPP_
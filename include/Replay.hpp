@@ -0,0 +1,178 @@
+#ifndef __REPLAY_HPP_
+#define __REPLAY_HPP_
+
+#include <Arduino.h>
+#include "EepromWriter.hpp"
+#include "globals.hpp"
+#include "Snake.hpp"
+#include "GameCore.hpp"
+
+// Replays
+// A game is decided by the seed it was reset with and the direction the snake went
+//	each tick so that is all a replay stores.  Each direction is a crumb, packed with
+//	a CrumbPtr the same way as the snake.  Ticks where the snake is not moving change
+//	nothing and are left out.
+//
+//	Layout:
+//		'H' 'W' 'R' version			4 bytes
+//		seed						4 bytes, little endian
+//		ticks						2 bytes, little endian
+//		flags						1 byte.  The level the game was on is the top 4 bits.
+//		blocks of 16 ticks:			4 bytes of crumbs then GameCore::checksum() after
+//									the last tick in the block.
+//
+//	The player checks every block's checksum so a replay that does not play back the
+//	same as the game it came from is spotted within 16 ticks.  A checksum every tick
+//	would name the tick but costs a byte a tick against a quarter of one for the
+//	direction, so a replay would take five times the room.  The player gives the block
+//	and its ticks instead.
+
+namespace Replay {
+
+	constexpr uint8_t version { 1 };
+	constexpr uint8_t headerSize { 11 };
+	constexpr uint8_t ticksPerBlock { 16 };
+	constexpr uint8_t blockSize { (ticksPerBlock / 4) + 1 };
+
+	// Flags
+	constexpr uint8_t truncated { 0x01 };	// Ran out of room before the game ended.
+	constexpr uint8_t finished { 0x02 };	// The game ended.
+	constexpr uint8_t levelShift { 4 };		// The level is flags >> this.
+
+	constexpr uint16_t sizeFor(uint16_t ticks) {
+		return headerSize + ((ticks + ticksPerBlock - 1) / ticksPerBlock) * blockSize;
+	}
+
+
+	// Records one game into a fixed buffer in RAM.
+	template <uint16_t Size>
+	class Recorder {
+
+		static_assert(Size >= headerSize + blockSize, "Replay buffer too small.");
+
+		uint8_t data[Size] {};
+		uint16_t m_ticks { 0 };
+		CrumbPtr m_write { data + headerSize, 0 };
+
+	public:
+		/**
+		 * @brief Start recording a new game.
+		 * @param seed The seed the game was reset with.
+		 * @param level The level it was reset with.
+		 */
+		void start(uint32_t seed, uint8_t level = 0);
+
+		/**
+		 * @brief Record the tick that has just been stepped.  Call after every GameCore::step().
+		 * @param game The game after the step.
+		 */
+		void record(const GameCore& game);
+
+		/**
+		 * @brief Close the recording once the game is over.
+		 * @param game The game at the end.
+		 */
+		void finish(const GameCore& game);
+
+		uint16_t ticks() const { return m_ticks; }
+		uint16_t size() const { return sizeFor(m_ticks); }
+		const uint8_t* bytes() const { return data; }
+
+		// Print as "REPLAY " and hex for the host player to read.
+		size_t printTo(Print& p) const;
+
+		// Copy to the EEPROM in the background.  Only the bytes that changed are written.
+		void save(uint16_t address) const;
+	};
+
+
+	// Reads a replay.
+	class Reader {
+
+		const uint8_t* data { nullptr };
+		uint16_t m_size { 0 };
+
+		uint16_t word(uint8_t at) const { return static_cast<uint16_t>(data[at] | (data[at + 1] << 8)); }
+
+	public:
+		Reader(const uint8_t* data, uint16_t size) : data{data}, m_size{size} {}
+
+		bool valid() const {
+			return m_size >= headerSize && data[0] == 'H' && data[1] == 'W' && data[2] == 'R' &&
+					data[3] == version && sizeFor(ticks()) <= m_size;
+		}
+		uint32_t seed() const { return word(4) | (static_cast<uint32_t>(word(6)) << 16); }
+		uint16_t ticks() const { return word(8); }
+		uint8_t flags() const { return data[10]; }
+		uint8_t level() const { return data[10] >> levelShift; }
+
+		Direction direction(uint16_t tick) const {
+			const uint8_t* block { data + headerSize + (tick / ticksPerBlock) * blockSize };
+			const uint8_t inBlock { static_cast<uint8_t>(tick % ticksPerBlock) };
+			CrumbPtr cp { const_cast<uint8_t*>(block) + (inBlock / 4), static_cast<uint8_t>(inBlock % 4) };
+			return cp.getValue();
+		}
+
+		// Checksums are stored after the last tick of each block.
+		bool hasChecksum(uint16_t tick) const { return ((tick + 1) % ticksPerBlock == 0) || (tick + 1 == ticks()); }
+		uint16_t block(uint16_t tick) const { return tick / ticksPerBlock; }
+		uint16_t blockStart(uint16_t tick) const { return block(tick) * ticksPerBlock; }
+		uint8_t checksum(uint16_t tick) const {
+			return data[headerSize + (tick / ticksPerBlock) * blockSize + (ticksPerBlock / 4)];
+		}
+	};
+
+
+	template <uint16_t Size>
+	void Recorder<Size>::start(uint32_t seed, uint8_t level) {
+		data[0] = 'H'; data[1] = 'W'; data[2] = 'R'; data[3] = version;
+		for (uint8_t i { 0 }; i < 4; ++i) data[4 + i] = static_cast<uint8_t>(seed >> (8 * i));
+		data[8] = data[9] = 0;
+		data[10] = static_cast<uint8_t>(level << levelShift);
+		m_ticks = 0;
+		m_write = { data + headerSize, 0 };
+	}
+
+	template <uint16_t Size>
+	void Recorder<Size>::record(const GameCore& game) {
+
+		if (game.direction() > Direction::DOWN || (data[10] & (truncated | finished))) return;
+		// Only happens at the end of a block so the recording stops with a checksum.
+		if (sizeFor(m_ticks + 1) > Size) { data[10] |= truncated; return; }
+
+		m_write.putValue(game.direction());
+		++m_write;
+		++m_ticks;
+		data[8] = static_cast<uint8_t>(m_ticks);
+		data[9] = static_cast<uint8_t>(m_ticks >> 8);
+
+		// The crumbs for a block are done.  Store the checksum and skip past it.
+		if (m_ticks % ticksPerBlock == 0) *m_write.ptr++ = game.checksum();
+	}
+
+	template <uint16_t Size>
+	void Recorder<Size>::finish(const GameCore& game) {
+
+		if (data[10] & finished) return;
+		if (m_ticks % ticksPerBlock != 0)
+			data[headerSize + (m_ticks / ticksPerBlock) * blockSize + (ticksPerBlock / 4)] = game.checksum();
+		data[10] |= finished;
+	}
+
+	template <uint16_t Size>
+	size_t Recorder<Size>::printTo(Print& p) const {
+		size_t n { p.print(F("REPLAY ")) };
+		for (uint16_t i { 0 }; i < size(); ++i) {
+			if (data[i] < 0x10) n += p.print('0');
+			n += p.print(data[i], HEX);
+		}
+		return n + p.println();
+	}
+
+	template <uint16_t Size>
+	void Recorder<Size>::save(uint16_t address) const {
+		for (uint16_t i { 0 }; i < size(); ++i) EepromWriter::update(address + i, data[i]);
+	}
+}
+
+#endif // __REPLAY_HPP_
@@ -2,6 +2,9 @@
 #define __RINGBUFFER_HPP_
 
 #include "stdint.h"
+#include "stddef.h"
+#include "assert.h"
+#include "Geometry.hpp"
 
 // A ring buffer is a memory structure where a contiguous block of memory is allocated at one end
 // and de-allocated at the other.  At one point the memory loops around and starts again.  As the 
@@ -19,12 +22,15 @@
 //  a snake body segment can be reduced to only taking half a nibble (4 bits) or a crumb (2 bits).
 
 
-template <typename T, uint8_t Size> // This is a C++ class template.  Only used functions are instantiated.
+template <typename T, size_t Size> // This is a C++ class template.  Only used functions are instantiated.
 class RingBuffer {
 
-static_assert(Size < 255, "Buffer too big.  This only takes up to 254.\n");
-
 public:
+	// Sizes are counted in the smallest type that can hold Size so small buffers still
+	//  use a byte on the avr.
+	using size_type = typename Utility::SelectType<(Size < 255), uint8_t,
+					  typename Utility::SelectType<(Size < 65535), uint16_t, uint32_t>::type>::type;
+
 	struct ForwardIterator;
 	struct ReverseIterator;
 
@@ -39,11 +45,11 @@ public:
     ReverseIterator rend() noexcept;
 	const ReverseIterator rend() const noexcept;
 
-    constexpr uint8_t size() const;
+    constexpr size_type size() const;
 	constexpr bool empty() const;
 	constexpr bool full() const;
-	constexpr uint8_t spaceRemaining() const;
-    constexpr uint8_t capacity() const;
+	constexpr size_type spaceRemaining() const;
+    constexpr size_type capacity() const;
 
     T& front();
     constexpr const T& front() const;
@@ -65,7 +71,7 @@ private:
 // We will create a template class which is a subclass of Ringbuffer<int>
 
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 struct RingBuffer<T, Size>::ForwardIterator {
 
 	friend class RingBuffer<T, Size>;
@@ -111,7 +117,7 @@ private:
 };
 
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 struct RingBuffer<T, Size>::ReverseIterator {
 
 	friend class RingBuffer<T, Size>;
@@ -159,97 +165,97 @@ private:
 
 // *** RingBuffer ***
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 RingBuffer<T, Size>::RingBuffer() : write{data, *this}, read{data, *this} {}
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator
 RingBuffer<T, Size>::begin() noexcept {
 	return ForwardIterator{ &*(write - 1), *this };
 }
 	
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator RingBuffer<T, Size>::end() noexcept {
 	return ForwardIterator{ &*(read - 1), *this };
 }
     
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator
 RingBuffer<T, Size>::rbegin() noexcept {
 	return read;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 const typename RingBuffer<T, Size>::ReverseIterator
 RingBuffer<T, Size>::rbegin() const noexcept {
 	return read;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator
 RingBuffer<T, Size>::rend() noexcept {
 	return write; 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 const typename RingBuffer<T, Size>::ReverseIterator
 RingBuffer<T, Size>::rend() const noexcept {
 	return write;
 }
     
 
-template<typename T, uint8_t Size>
-constexpr uint8_t RingBuffer<T, Size>::size() const {
+template<typename T, size_t Size>
+constexpr typename RingBuffer<T, Size>::size_type RingBuffer<T, Size>::size() const {
 	return ((write >= read) ? write - read : write - read + (Size + 1) );
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::empty() const {
 		return (size() == 0);
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::full() const {
 	return (write + 1 == read); 
 }
 
-template<typename T, uint8_t Size>
-constexpr uint8_t RingBuffer<T, Size>::spaceRemaining() const {
+template<typename T, size_t Size>
+constexpr typename RingBuffer<T, Size>::size_type RingBuffer<T, Size>::spaceRemaining() const {
 	return capacity() - size(); 
 }
 
-template<typename T, uint8_t Size>
-constexpr uint8_t RingBuffer<T, Size>::capacity() const {
+template<typename T, size_t Size>
+constexpr typename RingBuffer<T, Size>::size_type RingBuffer<T, Size>::capacity() const {
 	return Size; 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 T& RingBuffer<T, Size>::front() {
 	assert(!empty() && "Empty");
 	return *begin(); 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr const T& RingBuffer<T, Size>::front() const {
 	static_assert(!empty(), "empty");
 //	assert(!empty() && "Empty");
 	return *begin();
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 T& RingBuffer<T, Size>::back() {
 	assert(!empty() && "Empty");
 	return *read;  
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr const T& RingBuffer<T, Size>::back() const {
 	static_assert(!empty(), "empty");
 //	assert(!empty() && "Empty");
 	return *read; 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 bool RingBuffer<T, Size>::push(T data) {
 	if (write + 1 == read)
 		return false;
@@ -257,14 +263,14 @@ bool RingBuffer<T, Size>::push(T data) {
 	return true; 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 T RingBuffer<T, Size>::pop() {
 	assert(!empty() && "Cannot pop from empty buffer");
 	T rVal = *read; ++read;
 	return rVal;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 void RingBuffer<T, Size>::clear() {
 	write.ptr = data;
 	read.ptr = data;
@@ -273,29 +279,29 @@ void RingBuffer<T, Size>::clear() {
 
 // *** Forward Iterator ***
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 RingBuffer<T, Size>::ForwardIterator::ForwardIterator(pointer ptr, RingBuffer<T, Size>& buf) : ptr{ptr}, buf{buf} {}
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator::reference
 RingBuffer<T, Size>::ForwardIterator::operator*() {
 	return *ptr; 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ForwardIterator::const_reference
 RingBuffer<T, Size>::ForwardIterator::operator*() const { 
 	return *ptr; 
 }
 
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator::pointer
 RingBuffer<T, Size>::ForwardIterator::operator->() {
 	return ptr;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ForwardIterator::const_pointer
 RingBuffer<T, Size>::ForwardIterator::operator->() const {
 	return ptr;
@@ -304,14 +310,14 @@ RingBuffer<T, Size>::ForwardIterator::operator->() const {
 
 // Unary operators
 // prefix
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator::self_type
 RingBuffer<T, Size>::ForwardIterator::operator++() {
 	if (--ptr < buf.data) ptr = buf.data + Size;
 	return *this;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator::self_type
 RingBuffer<T, Size>::ForwardIterator::operator--() {
 	if (++ptr == &buf.data[Size + 1]) ptr = buf.data;
@@ -319,7 +325,7 @@ RingBuffer<T, Size>::ForwardIterator::operator--() {
 }
 
 // postfix
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator::self_type
 RingBuffer<T, Size>::ForwardIterator::operator++(int) {
 	self_type rVal = *this;
@@ -327,7 +333,7 @@ RingBuffer<T, Size>::ForwardIterator::operator++(int) {
 	return rVal; 
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 typename RingBuffer<T, Size>::ForwardIterator::self_type
 RingBuffer<T, Size>::ForwardIterator::operator--(int) {
 	self_type rVal = *this;
@@ -337,42 +343,42 @@ RingBuffer<T, Size>::ForwardIterator::operator--(int) {
 
 
 // Comparison operators
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ForwardIterator::operator==(const self_type& other) const {
 	return other.ptr == this->ptr;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ForwardIterator::operator!=(const self_type& other) const {
 	return other.ptr != this->ptr;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ForwardIterator::operator<=(const self_type& other) const {
 	return this->ptr >= other.ptr;
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ForwardIterator::operator>=(const self_type& other) const {
 	return this->ptr <= other.ptr;
 }
 
 
 // Arithmetic operators
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ForwardIterator::self_type
 RingBuffer<T, Size>::ForwardIterator::operator-(const difference_type& distance) const {
 	return self_type(buf.data + ((ptr - buf.data + distance) % (Size + 1)), buf);
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ForwardIterator::self_type
 RingBuffer<T, Size>::ForwardIterator::operator+(const difference_type& distance) const {
 	auto indexOfResult = ((ptr - buf.data) + ((Size + 1) - distance)) % (Size + 1);
 	return self_type(buf.data + indexOfResult, buf);
 }
 
-template<typename T, uint8_t Size>
+template<typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ForwardIterator::difference_type
 RingBuffer<T, Size>::ForwardIterator::operator-(const self_type& other) const {
 	//return this->ptr - other->ptr;
@@ -384,29 +390,29 @@ RingBuffer<T, Size>::ForwardIterator::operator-(const self_type& other) const {
 
 // *** Reverse Iterator ***
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 RingBuffer<T, Size>::ReverseIterator::ReverseIterator(pointer ptr, RingBuffer<T, Size>& buf) : ptr{ptr}, buf{buf} {}
 
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator::reference
 RingBuffer<T, Size>::ReverseIterator::operator*() {
 	return *ptr;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ReverseIterator::const_reference
 RingBuffer<T, Size>::ReverseIterator::operator*() const {
 	return *ptr;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator::pointer
 RingBuffer<T, Size>::ReverseIterator::operator->() {
 	return ptr;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ReverseIterator::const_pointer
 RingBuffer<T, Size>::ReverseIterator::operator->() const {
 	return ptr;
@@ -415,7 +421,7 @@ RingBuffer<T, Size>::ReverseIterator::operator->() const {
 
 // Unary operators
 // prefix
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator::self_type
 RingBuffer<T, Size>::ReverseIterator::operator++() {
 	if (++ptr == &buf.data[Size + 1]) 
@@ -423,7 +429,7 @@ RingBuffer<T, Size>::ReverseIterator::operator++() {
 	return *this;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator::self_type
 RingBuffer<T, Size>::ReverseIterator::operator--() {
 	if (--ptr < buf.data)
@@ -432,14 +438,14 @@ RingBuffer<T, Size>::ReverseIterator::operator--() {
 }
 
 // postfix
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator::self_type
 RingBuffer<T, Size>::ReverseIterator::operator++(int) {
 	self_type rVal = *this; ++(*this);
 	return rVal;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 typename RingBuffer<T, Size>::ReverseIterator::self_type
 RingBuffer<T, Size>::ReverseIterator::operator--(int) {
 	self_type rVal = *this;
@@ -449,42 +455,42 @@ RingBuffer<T, Size>::ReverseIterator::operator--(int) {
 
 
 // Comparison operators
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ReverseIterator::operator==(const self_type& other) const {
 	return this->ptr == other.ptr;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ReverseIterator::operator!=(const self_type& other) const {
 	return this->ptr != other.ptr;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ReverseIterator::operator<=(const self_type& other) const {
 	return this->ptr <= other.ptr;
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr bool RingBuffer<T, Size>::ReverseIterator::operator>=(const self_type& other) const {
 	return this->ptr >= other.ptr;
 }
 
 
 // Arithmetic operators
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ReverseIterator::self_type
 RingBuffer<T, Size>::ReverseIterator::operator+(const difference_type& distance) const {
 	return self_type(buf.data + ((ptr - buf.data + distance) % (Size + 1)), buf);
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ReverseIterator::self_type
 RingBuffer<T, Size>::ReverseIterator::operator-(const difference_type& distance) const {
 	auto indexOfResult = ((ptr - buf.data) + ((Size + 1) - distance)) % (Size + 1);
 	return self_type(buf.data + indexOfResult, buf);
 }
 
-template <typename T, uint8_t Size>
+template <typename T, size_t Size>
 constexpr typename RingBuffer<T, Size>::ReverseIterator::difference_type
 RingBuffer<T, Size>::ReverseIterator::operator-(const self_type& other) const {
 	//return this->ptr - other->ptr;
@@ -76,7 +76,7 @@ struct CrumbPtr
 //    ---- memory ----
 // <  ================  <0>
 //  memstart       memend
-template <uint8_t SNAKE_DATA_SIZE, typename POINT_TYPE>
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
 class Snake 
 #if (DEBUG == YES)
 : public Printable
@@ -84,7 +84,7 @@ class Snake
 {
 
 	uint8_t data[SNAKE_DATA_SIZE] {};
-	uint16_t m_length { 0 };
+	SnakeLengthType m_length { 0 };
 	Direction m_dir { Direction::NONE };
 	POINT_TYPE m_head {};
 	POINT_TYPE m_tail {};
@@ -94,10 +94,16 @@ class Snake
 public:
     
 	//Snake() : data{}, m_length{}, m_dir{Direction::NONE}, m_head{}, m_tail{}, memstart{data, 0}, memend {data, 0}  {}
-    uint16_t capacity() const { return 1 + (sizeof(data) * 4); }
+	Snake() = default;
+	// memstart and memend point into data so they have to be moved to the new data
+	//  when a snake is copied.  The default copy would leave them in the old snake.
+	Snake(const Snake& other) { *this = other; }
+	Snake& operator=(const Snake& other);
+
+    SnakeLengthType capacity() const { return 1 + (sizeof(data) * 4); }
     bool full() const { return ( m_length == capacity() ); }
     bool empty() const { return ( m_length == 0 ); }
-    uint16_t length() const { return m_length; }
+    SnakeLengthType length() const { return m_length; }
     const POINT_TYPE& head() const { return m_head; } 
     const POINT_TYPE& tail() const { return m_tail; }
 	Direction getDirection() const { return m_dir; }
@@ -110,7 +116,27 @@ public:
 	// Access index using subscript operator.
 	const POINT_TYPE operator[](size_t index) const;
 	// Point is in the snake. and return detected point.
-	OptionalPoint<POINT_DATA_TYPE> pointIsInside(const POINT_TYPE& p);
+	OptionalPoint<POINT_DATA_TYPE> pointIsInside(const POINT_TYPE& p) const;
+	// Call f(point) for every segment from the tail to the head.  One pass of the data
+	//  where doing the same with operator[] would walk it once for every segment.
+	template <typename Function>
+	void forEachSegment(Function f) const;
+
+	// Steps from the tail to the head a segment at a time, like forEachSegment() but the
+	//  caller decides when to take the next one.  Searches use it to free the cells in the
+	//  order the tail will leave them.  The snake must not change while it is used.
+	class Walker {
+	public:
+		explicit Walker(const Snake& snake) : m_snake { snake }, m_point { snake.m_tail }, m_it { snake.memstart }, m_left { snake.m_length } {}
+		bool done() const { return m_left == 0; }
+		const POINT_TYPE& point() const { return m_point; }
+		void next();
+	private:
+		const Snake& m_snake;
+		POINT_TYPE m_point;
+		CrumbPtr m_it;
+		SnakeLengthType m_left;
+	};
 
 #if (DEBUG == YES)
 	size_t printTo(Print& p) const;
@@ -118,7 +144,21 @@ public:
 };
 
 
-template <uint8_t SNAKE_DATA_SIZE, typename POINT_TYPE>
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
+Snake<SNAKE_DATA_SIZE, POINT_TYPE>& Snake<SNAKE_DATA_SIZE, POINT_TYPE>::operator=(const Snake& other) {
+
+	if (this == &other) return *this;
+	memcpy(data, other.data, sizeof(data));
+	m_length = other.m_length;
+	m_dir = other.m_dir;
+	m_head = other.m_head;
+	m_tail = other.m_tail;
+	memstart = { data + (other.memstart.ptr - other.data), other.memstart.crumb };
+	memend = { data + (other.memend.ptr - other.data), other.memend.crumb };
+	return *this;
+}
+
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
 bool Snake<SNAKE_DATA_SIZE, POINT_TYPE>::push(const POINT_TYPE& p) {
     
 	//DEBUG_PRINT("Len: ");
@@ -132,7 +172,8 @@ bool Snake<SNAKE_DATA_SIZE, POINT_TYPE>::push(const POINT_TYPE& p) {
         else if (p.y + 1 == m_head.y) { memend.putValue(Direction::UP); }
         else if (p.x + 1 == m_head.x) { memend.putValue(Direction::RIGHT); }
         else {
-			DEBUG_PRINTLN_FLASH("Error. Bad insert.\n");
+			TRACE_EVENT(BadInsert, Trace::cell(p));
+			REPORT_ERROR(BadInsert);
 			//exit(1);
 		}
         
@@ -152,13 +193,11 @@ bool Snake<SNAKE_DATA_SIZE, POINT_TYPE>::push(const POINT_TYPE& p) {
     return true;
 }
 
-template <uint8_t SNAKE_DATA_SIZE, typename POINT_TYPE>
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
 const POINT_TYPE Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pop() {
 
     if (empty()) { return POINT_TYPE { 0, 0 }; } // Should never be empty in the game.
 
-    DEBUG_PRINT_FLASH("Len: ");
-	DEBUG_PRINTLN(m_length);
 	const POINT_TYPE rval = m_tail;
 	if (m_length == 1) { 
 		m_tail = m_head = { 0, 0 };
@@ -172,7 +211,6 @@ const POINT_TYPE Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pop() {
 		memstart.crumb = memend.crumb = 0;
 		return rval; 
 	} // Length of 2 so tail set to head and no need to adjust the buffer.
-    DEBUG_PRINTLN("p");
     switch(~memstart.getValue()) {
         
         case Direction::UP: m_tail += { 1, 0 }; break;
@@ -190,19 +228,18 @@ const POINT_TYPE Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pop() {
 	
 //	DEBUG_PRINTLN_FLASH("m_length--");
     m_length--;
-	DEBUG_PRINTLN("r");
     return rval;
 }
 
 #pragma message "Would be more efficient if index was counted from closest end of snake."
-template <uint8_t SNAKE_DATA_SIZE, typename POINT_TYPE>
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
 const POINT_TYPE Snake<SNAKE_DATA_SIZE, POINT_TYPE>::operator[](size_t index) const {
 	// we are talking head to tail index here.
 	// tail to head is counting forward and head to tail is counting backwards.
 	
-	// Print an error.
+	// Keep an error.
 	if (index + 1 > m_length) { 
-		Error::displayError(__LINE__, __FILE__, "Out of range access.");
+		REPORT_ERROR(OutOfRange);
 		return {0, 0}; 
 	}
 	if (index == 0) { return m_head; };
@@ -230,8 +267,8 @@ const POINT_TYPE Snake<SNAKE_DATA_SIZE, POINT_TYPE>::operator[](size_t index) co
 }
 
 
-template <uint8_t SNAKE_DATA_SIZE, typename POINT_TYPE>
-OptionalPoint<POINT_DATA_TYPE> Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pointIsInside(const POINT_TYPE& p) {
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
+OptionalPoint<POINT_DATA_TYPE> Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pointIsInside(const POINT_TYPE& p) const {
 	
 	if (p == m_head) return { m_head };
 	if (m_length == 1) return OptionalPoint<POINT_DATA_TYPE>();
@@ -254,7 +291,7 @@ OptionalPoint<POINT_DATA_TYPE> Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pointIsInside
 
 	for (;; cp--) {
 
-		if (cp.ptr < data) cp.ptr = data + (sizeof(data) - 1);
+		if (cp.ptr < data) cp.ptr = const_cast<uint8_t*>(data) + (sizeof(data) - 1);
 
 //		DEBUG_PRINT_FLASH("cp: "); DEBUG_PRINTLN(cp);
 		
@@ -275,8 +312,53 @@ OptionalPoint<POINT_DATA_TYPE> Snake<SNAKE_DATA_SIZE, POINT_TYPE>::pointIsInside
 }
 
 
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
+template <typename Function>
+void Snake<SNAKE_DATA_SIZE, POINT_TYPE>::forEachSegment(Function f) const {
+
+	if (m_length == 0) return;
+
+	POINT_TYPE pnt { m_tail };
+	auto it { memstart };
+	f(pnt);
+
+	for (SnakeLengthType i { 1 }; i < m_length; ++i) {
+
+		switch(~it.getValue()) {
+			case Direction::UP: 	pnt += { 1, 0 }; break;
+			case Direction::DOWN: 	pnt -= { 1, 0 }; break;
+			case Direction::LEFT: 	pnt -= { 0, 1 }; break;
+			case Direction::RIGHT: 	pnt += { 0, 1 }; break;
+			default: exit(1);
+		}
+		f(pnt);
+
+		++it;
+		if (it.ptr > data + sizeof(data) - 1) it.ptr = const_cast<uint8_t*>(data);
+	}
+}
+
+
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
+void Snake<SNAKE_DATA_SIZE, POINT_TYPE>::Walker::next() {
+
+	if (m_left == 0 || --m_left == 0) return;
+
+	switch(~m_it.getValue()) {
+		case Direction::UP: 	m_point += { 1, 0 }; break;
+		case Direction::DOWN: 	m_point -= { 1, 0 }; break;
+		case Direction::LEFT: 	m_point -= { 0, 1 }; break;
+		case Direction::RIGHT: 	m_point += { 0, 1 }; break;
+		default: exit(1);
+	}
+
+	++m_it;
+	if (m_it.ptr > m_snake.data + sizeof(m_snake.data) - 1) m_it.ptr = const_cast<uint8_t*>(m_snake.data);
+}
+
+
 #if (DEBUG == YES)
-template <uint8_t SNAKE_DATA_SIZE, typename POINT_TYPE>
+template <SnakeDataSizeType SNAKE_DATA_SIZE, typename POINT_TYPE>
 size_t Snake<SNAKE_DATA_SIZE, POINT_TYPE>::printTo(Print& p) const {
 	
 	size_t count {0};
@@ -286,7 +368,7 @@ size_t Snake<SNAKE_DATA_SIZE, POINT_TYPE>::printTo(Print& p) const {
 	DEBUG_PRINT_FLASH("<<<");
 	count += p.print(m_tail);
 
-	for (uint16_t i = 0; i < m_length - 1; ++i) {
+	for (SnakeLengthType i = 0; i < m_length - 1; ++i) {
 
 		switch(~it.getValue()) {
             
@@ -0,0 +1,56 @@
+#ifndef __SNAPSHOT_HPP_
+#define __SNAPSHOT_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "GameCore.hpp"
+
+// Snapshot
+// The whole of a game saved in the EEPROM when it is paused so that turning it off and
+//	on again carries on from there.  It is discarded when the game carries on, so a pause
+//	is the only save point.  Only what the game needs is kept and the body is the
+//	way each segment goes from the one before, a crumb each, so it is as long as the
+//	snake is rather than as long as it could be.
+//
+//	Layout:
+//		'P' version					2 bytes.  The 'P' is cleared first, written last and cleared by discard().
+//		length						1 byte
+//		tail						1 byte, row * width + column.
+//		direction					1 byte
+//		scran						1 byte, row * width + column.
+//		score						2 bytes, little endian.
+//		update time					2 bytes, little endian.
+//		random state				4 bytes, little endian.
+//		level						1 byte
+//		body						(length - 1) crumbs, tail to head, 4 to a byte.
+//		CRC-8 of the above			1 byte
+//
+//	A snapshot that fails its CRC, or was cut off while being written, is not restored.
+
+namespace Snapshot {
+
+	constexpr uint8_t version { 2 };
+	constexpr uint8_t headerSize { 15 };
+
+	constexpr uint16_t sizeFor(SnakeLengthType length) { return headerSize + (length + 2) / 4 + 1; }
+
+	/**
+	 * @brief Save the game in the background with EepromWriter.
+	 * @param game The game.
+	 * @return The bytes in the snapshot.
+	 */
+	uint8_t save(const GameCore& game);
+
+	/**
+	 * @brief Put the saved game in game if there is a good one.
+	 * @param game Changed only if the snapshot is good.
+	 * @return true if it was restored.
+	 */
+	bool restore(GameCore& game);
+
+	// Forget the saved game so that it is not restored.  Once the game it came from is over
+	//	or carries on.
+	void discard();
+}
+
+#endif // __SNAPSHOT_HPP_
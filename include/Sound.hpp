@@ -0,0 +1,87 @@
+#ifndef __SOUND_HPP_
+#define __SOUND_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+
+// Sound
+// Tunes played in the background by a Timer2 interrupt that toggles Pin::BUZZER, so an
+//	effect costs the game loop one call to play() and nothing while it sounds.  tone()
+//	uses Timer2 too and cannot be used with it.
+//
+//	A tune is a list of notes in flash.  Each note holds the Timer2 settings for its
+//	pitch worked out at compile time, so starting a note in the interrupt is a few
+//	register writes with no dividing.  Tunes wait in a short queue and each effect has a
+//	priority.  A higher one cuts off what is playing and empties the queue, the same one
+//	is queued after it and a lower one is dropped.
+
+namespace Sound {
+
+	enum class Effect : uint8_t { Eat, Crash, GameOver, HighScore };
+
+	enum class Priority : uint8_t { Low, High, Top };
+
+	constexpr uint8_t QueueDepth { 4 };		// Tunes waiting.  A power of 2.
+
+	// A note, or a rest when clock has Rest set.  A tune ends with a count of 0.
+	struct Note {
+		uint8_t clock;		// Timer2's clock select bits.
+		uint8_t top;		// OCR2A.  The pin changes every top + 1 counts.
+		uint16_t count;		// Compare matches the note lasts.
+	};
+
+	constexpr uint8_t Rest { 0x80 };
+
+	// The Timer2 prescalers for clock select bits 1 to 7.
+	constexpr uint16_t prescaler(uint8_t clock) {
+		return (clock == 1) ? 1 : (clock == 2) ? 8 : (clock == 3) ? 32 : (clock == 4) ? 64 :
+			   (clock == 5) ? 128 : (clock == 6) ? 256 : 1024;
+	}
+
+	// The smallest prescaler whose top fits in 8 bits for half a period of frequency.
+	constexpr uint8_t clockFor(uint16_t frequency_Hz, uint8_t clock = 1) {
+		return (clock == 7 || F_CPU / (prescaler(clock) * 2UL * frequency_Hz) <= 256) ? clock : clockFor(frequency_Hz, clock + 1);
+	}
+
+	constexpr Note note(uint16_t frequency_Hz, uint16_t duration_ms) {
+		return {
+			clockFor(frequency_Hz),
+			static_cast<uint8_t>(F_CPU / (prescaler(clockFor(frequency_Hz)) * 2UL * frequency_Hz) - 1),
+			static_cast<uint16_t>(2UL * frequency_Hz * duration_ms / 1000)
+		};
+	}
+
+	// Silence with the interrupt going off every ms.
+	constexpr Note rest(uint16_t duration_ms) { return { static_cast<uint8_t>(Rest | 4), 249, duration_ms }; }
+
+	constexpr Note end { 0, 0, 0 };
+
+#if (SOUND == YES)
+	// Set up the pin.  Call once from setup().
+	void begin();
+
+	/**
+	 * @brief Play an effect's tune in the background, depending on its priority.
+	 * @param effect The effect.
+	 */
+	void play(Effect effect);
+
+	// A tune is playing or waiting.
+	bool playing();
+
+	// For the debug output.  Time is in CPU cycles, timed with a CycleCounter.
+	struct Counters {
+		uint32_t interrupts { 0 };
+		uint32_t cycles { 0 };		// In all of them.
+		uint16_t worstCycles { 0 };
+		uint16_t dropped { 0 };		// Tunes not played for priority or a full queue.
+	};
+	Counters counters();
+#else
+	inline void begin() {}
+	inline void play(Effect) {}
+	inline bool playing() { return false; }
+#endif
+}
+
+#endif // __SOUND_HPP_
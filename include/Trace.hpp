@@ -0,0 +1,79 @@
+#ifndef __TRACE_HPP_
+#define __TRACE_HPP_
+
+#include <Arduino.h>
+
+// Trace
+// What the game does each tick, kept as 4 byte records in a ring in RAM rather than
+//	printed as text where it happens.  A record is a few stores so tracing hardly changes
+//	the timing, and the snake keeps its release size in debug builds.  drain() sends the
+//	records over serial between ticks, only as many as fit in the serial transmit buffer
+//	so it never waits.  If the ring fills before it is drained new records are counted
+//	and dropped until all those kept have been sent, and then a Lost record says how
+//	many, so the gap is where the Lost record is.
+//
+//	Each line sent is "TRACE " then the hex of up to lineRecords records:
+//		id							1 byte, an Id.
+//		tick						1 byte, the low byte of the tick.  A Tick record is
+//									added every 256 ticks with the whole count.
+//		value						2 bytes, little endian.  Cells are row * 256 + column.
+//
+//	tools/trace_decoder reads a saved serial log and prints the records as text with
+//	the rest of the log.  Only add to the trace from the main loop, not from interrupts.
+
+namespace Trace {
+
+	// Add new ids at the end and give them a name in tools/trace_decoder.
+	enum class Id : uint8_t {
+		Tick,			// The whole tick count.
+		Input,			// The direction given to GameCore::step().
+		Moved,			// The cell the head moved to.
+		Tail,			// The cell the tail left.
+		Scran,			// Where new scran was put.
+		Ate,			// The score after eating.
+		HitWall,		// The head that tried to leave the world or go into a wall.
+		HitSelf,		// The cell the snake tried to move into.
+		BadInsert,		// A cell pushed that was not next to the head.
+		Autopilot,		// The cycles the autopilot took to decide.
+		Lost			// Records dropped as the ring was full.  Only in what is sent.
+	};
+
+	constexpr uint8_t Depth { 32 };			// Records the ring holds.  A power of 2.
+	constexpr uint8_t recordSize { 4 };
+	constexpr uint8_t lineRecords { 6 };	// At most 6 * 8 + 7 characters a line.
+
+	struct Record {
+		Id id;
+		uint8_t tick;
+		uint16_t value;
+	};
+
+	// The ring.  add() puts records in at tail and drain() takes them from head.  Both
+	//	count up and wrap so tail - head is the number waiting.
+	extern Record records[Depth];
+	extern uint8_t head, tail;
+	extern uint16_t tick, lost;
+
+	inline void add(Id id, uint16_t value) {
+		// Still dropping until the Lost record has gone, so nothing comes before it.
+		if (lost != 0 || static_cast<uint8_t>(tail - head) == Depth) {
+			if (lost != 0xFFFF) ++lost;
+			return;
+		}
+		records[tail & (Depth - 1)] = { id, static_cast<uint8_t>(tick), value };
+		++tail;
+	}
+
+	// Start the next tick.  Call once for each turn of the game loop.
+	inline void nextTick() {
+		if (static_cast<uint8_t>(++tick) == 0) add(Id::Tick, tick);
+	}
+
+	template <typename PointT>
+	inline uint16_t cell(const PointT& p) { return static_cast<uint16_t>((p.y << 8) | static_cast<uint8_t>(p.x)); }
+
+	// Send what fits in the serial transmit buffer without waiting.  Call when idle.
+	void drain();
+}
+
+#endif // __TRACE_HPP_
@@ -0,0 +1,299 @@
+#ifndef __TURNSNAKE_HPP_
+#define __TURNSNAKE_HPP_
+
+#include <Arduino.h>
+#include "globals.hpp"
+#include "Geometry.hpp"
+#include "Snake.hpp"
+
+
+// A snake stored as a list of turns.
+//  Snake keeps a crumb for every segment so its memory grows with the length of the snake
+//  and SNAKE_DATA_SIZE stops it at 1021 segments.  This keeps one run for each straight
+//  part of the snake instead: the direction it goes in and how many segments long it is.
+//  The runs are kept in a ring, tail run first.  Pushing a head that carries on in the
+//  same direction only adds one to the last run and popping the tail only takes one off
+//  the first so both are O(1).  pushTail() and popHead() do the same at the other ends,
+//  so a search can undo a move with popHead() then pushTail() of the old tail.
+//  pointIsInside() and operator[] step over a whole run at a time so they cost one step
+//  for each turn and not for each segment.
+//
+//  So memory goes with how twisty the snake is and not how long it is.  A snake that goes
+//  back and forth across a 256 wide board needs 2 runs every 256 segments.  The worst
+//  case is a snake that turns at every segment which takes 2 bytes a segment where
+//  Snake takes 2 bits.
+//
+//    tail                  head
+//     o-->-->-->o-->-->-->@       run 0: RIGHT 3, run 1: DOWN 1, run 2: RIGHT 3
+//               |
+//               o
+//
+//  Unlike Snake it holds no pointers into itself so the default copy is fine.
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE = uint16_t>
+class TurnSnake
+#if (DEBUG == YES)
+: public Printable
+#endif
+{
+	using DataT = decltype(POINT_TYPE::y);
+
+	static_assert(MAX_TURNS > 0, "There has to be room for at least one run.");
+
+	// A straight part of the snake.  count segments each one step in dir from the last.
+	struct Run {
+		Direction dir;
+		DataT count;
+	};
+
+	Run runs[MAX_TURNS] {};
+	uint16_t m_first { 0 };		// Index of the run at the tail.
+	uint16_t m_turns { 0 };		// Number of runs in use.
+	LENGTH_TYPE m_length { 0 };
+	Direction m_dir { Direction::NONE };
+	POINT_TYPE m_head {};
+	POINT_TYPE m_tail {};
+
+	uint16_t next(uint16_t i) const { return (i + 1 == MAX_TURNS) ? 0 : i + 1; }
+	uint16_t prev(uint16_t i) const { return (i == 0) ? MAX_TURNS - 1 : i - 1; }
+	uint16_t last() const { return (m_first + m_turns - 1) % MAX_TURNS; }
+
+	// The point n steps from p in direction d.
+	static POINT_TYPE moved(const POINT_TYPE& p, Direction d, DataT n);
+	// The direction to go from a to get to b if they are next to each other else NONE.
+	static Direction directionBetween(const POINT_TYPE& a, const POINT_TYPE& b);
+	// If p is one of the count segments behind end along a run going in direction d.
+	static bool onRun(const POINT_TYPE& p, const POINT_TYPE& end, Direction d, DataT count);
+
+public:
+
+	// The longest the snake can be whatever shape it is.
+	LENGTH_TYPE capacity() const { return static_cast<LENGTH_TYPE>(~LENGTH_TYPE{ 0 }); }
+	uint16_t turnCapacity() const { return MAX_TURNS; }
+	uint16_t turns() const { return m_turns; }
+	bool full() const { return m_length == capacity() || m_turns == MAX_TURNS; }
+	bool empty() const { return ( m_length == 0 ); }
+	LENGTH_TYPE length() const { return m_length; }
+	const POINT_TYPE& head() const { return m_head; }
+	const POINT_TYPE& tail() const { return m_tail; }
+	Direction getDirection() const { return m_dir; }
+	void setDirection(Direction d) { m_dir = d; }
+
+	// Pushing adds to the head end.  p must be next to the head.  Fails if there is not
+	//  room for another turn.
+	bool push(const POINT_TYPE& p);
+	// Popping takes from the tail end.
+	const POINT_TYPE pop();
+	// Adds to the tail end.  p must be next to the tail.  Fails if there is not room for
+	//  another turn.
+	bool pushTail(const POINT_TYPE& p);
+	// Takes from the head end.
+	const POINT_TYPE popHead();
+	// Index counted from the head.
+	const POINT_TYPE operator[](LENGTH_TYPE index) const;
+	// Point is in the snake.  Returns the point if it is.  Checked from the head back.
+	OptionalPoint<POINT_DATA_TYPE> pointIsInside(const POINT_TYPE& p) const;
+
+#if (DEBUG == YES)
+	size_t printTo(Print& p) const;
+#endif
+};
+
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+POINT_TYPE TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::moved(const POINT_TYPE& p, Direction d, DataT n) {
+	switch (d) {
+		case Direction::UP: 	return { static_cast<DataT>(p.y - n), p.x };
+		case Direction::DOWN: 	return { static_cast<DataT>(p.y + n), p.x };
+		case Direction::LEFT: 	return { p.y, static_cast<DataT>(p.x - n) };
+		case Direction::RIGHT: 	return { p.y, static_cast<DataT>(p.x + n) };
+		default: 				return p;
+	}
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+Direction TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::directionBetween(const POINT_TYPE& a, const POINT_TYPE& b) {
+	if (a.x == b.x) {
+		if (static_cast<DataT>(a.y + 1) == b.y) return Direction::DOWN;
+		if (static_cast<DataT>(b.y + 1) == a.y) return Direction::UP;
+	}
+	else if (a.y == b.y) {
+		if (static_cast<DataT>(a.x + 1) == b.x) return Direction::RIGHT;
+		if (static_cast<DataT>(b.x + 1) == a.x) return Direction::LEFT;
+	}
+	return Direction::NONE;
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+bool TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::onRun(const POINT_TYPE& p, const POINT_TYPE& end, Direction d, DataT count) {
+	// The run ends at end so its segments are behind it, the opposite way to d.
+	switch (d) {
+		case Direction::UP: 	return p.x == end.x && p.y > end.y && static_cast<DataT>(p.y - end.y) <= count;
+		case Direction::DOWN: 	return p.x == end.x && p.y < end.y && static_cast<DataT>(end.y - p.y) <= count;
+		case Direction::LEFT: 	return p.y == end.y && p.x > end.x && static_cast<DataT>(p.x - end.x) <= count;
+		case Direction::RIGHT: 	return p.y == end.y && p.x < end.x && static_cast<DataT>(end.x - p.x) <= count;
+		default: 				return false;
+	}
+}
+
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+bool TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::push(const POINT_TYPE& p) {
+
+	if (m_length == 0) {
+		m_head = m_tail = p;
+		m_length = 1;
+		return true;
+	}
+	if (m_length == capacity()) return false;
+
+	const Direction d { directionBetween(m_head, p) };
+	if (d == Direction::NONE) {
+		DEBUG_PRINTLN_FLASH("Error. Bad insert.\n");
+		return false;
+	}
+
+	// Carry on the run at the head if going the same way.  Else it is a turn.
+	if (m_turns > 0 && runs[last()].dir == d && runs[last()].count != static_cast<DataT>(~DataT{ 0 }))
+		++runs[last()].count;
+	else {
+		if (m_turns == MAX_TURNS) return false;
+		++m_turns;
+		runs[last()] = { d, 1 };
+	}
+
+	m_head = p;
+	++m_length;
+	return true;
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+const POINT_TYPE TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::pop() {
+
+	if (empty()) { return POINT_TYPE { 0, 0 }; } // Should never be empty in the game.
+
+	const POINT_TYPE rval { m_tail };
+	if (m_length == 1) {
+		m_tail = m_head = { 0, 0 };
+		m_length = 0;
+		m_first = m_turns = 0;
+		return rval;
+	}
+
+	// The tail moves one along the first run.  When the run is used up it is dropped.
+	Run& r { runs[m_first] };
+	m_tail = moved(m_tail, r.dir, 1);
+	if (--r.count == 0) {
+		m_first = next(m_first);
+		--m_turns;
+	}
+	--m_length;
+	return rval;
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+bool TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::pushTail(const POINT_TYPE& p) {
+
+	if (m_length == 0) return push(p);
+	if (m_length == capacity()) return false;
+
+	// The runs go from the tail to the head so the new run goes from p to the tail.
+	const Direction d { directionBetween(p, m_tail) };
+	if (d == Direction::NONE) {
+		DEBUG_PRINTLN_FLASH("Error. Bad insert.\n");
+		return false;
+	}
+
+	if (m_turns > 0 && runs[m_first].dir == d && runs[m_first].count != static_cast<DataT>(~DataT{ 0 }))
+		++runs[m_first].count;
+	else {
+		if (m_turns == MAX_TURNS) return false;
+		m_first = prev(m_first);
+		++m_turns;
+		runs[m_first] = { d, 1 };
+	}
+
+	m_tail = p;
+	++m_length;
+	return true;
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+const POINT_TYPE TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::popHead() {
+
+	if (empty()) { return POINT_TYPE { 0, 0 }; }
+
+	const POINT_TYPE rval { m_head };
+	if (m_length == 1) {
+		m_tail = m_head = { 0, 0 };
+		m_length = 0;
+		m_first = m_turns = 0;
+		return rval;
+	}
+
+	// The head moves back one along the last run.  When the run is used up it is dropped.
+	Run& r { runs[last()] };
+	m_head = moved(m_head, ~r.dir, 1);
+	if (--r.count == 0) --m_turns;
+	--m_length;
+	return rval;
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+const POINT_TYPE TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::operator[](LENGTH_TYPE index) const {
+
+	if (index + 1 > m_length) {
+		REPORT_ERROR(OutOfRange);
+		return {0, 0};
+	}
+
+	// Walk back from the head a run at a time until the run with the index in it.
+	POINT_TYPE p { m_head };
+	uint16_t i { last() };
+	for (uint16_t t { 0 }; t < m_turns; ++t, i = prev(i)) {
+		const Run& r { runs[i] };
+		if (index <= r.count) return moved(p, ~r.dir, static_cast<DataT>(index));
+		p = moved(p, ~r.dir, r.count);
+		index -= r.count;
+	}
+	return p;
+}
+
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+OptionalPoint<POINT_DATA_TYPE> TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::pointIsInside(const POINT_TYPE& p) const {
+
+	if (m_length == 0) return OptionalPoint<POINT_DATA_TYPE>();
+	if (p == m_head) return { m_head };
+
+	POINT_TYPE end { m_head };
+	uint16_t i { last() };
+	for (uint16_t t { 0 }; t < m_turns; ++t, i = prev(i)) {
+		const Run& r { runs[i] };
+		if (onRun(p, end, r.dir, r.count)) return { p };
+		end = moved(end, ~r.dir, r.count);
+	}
+	return OptionalPoint<POINT_DATA_TYPE>{};
+}
+
+
+#if (DEBUG == YES)
+template <uint16_t MAX_TURNS, typename POINT_TYPE, typename LENGTH_TYPE>
+size_t TurnSnake<MAX_TURNS, POINT_TYPE, LENGTH_TYPE>::printTo(Print& p) const {
+
+	size_t count {0};
+	count += p.print(F("<<<"));
+	count += p.print(m_tail);
+
+	uint16_t i { m_first };
+	for (uint16_t t { 0 }; t < m_turns; ++t, i = next(i)) {
+		count += p.print(' ');
+		count += p.print(static_cast<uint8_t>(runs[i].dir));
+		count += p.print('x');
+		count += p.print(runs[i].count);
+	}
+
+	count += p.print(F(":=<"));
+	return count;
+}
+#endif
+
+#endif // __TURNSNAKE_HPP_
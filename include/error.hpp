@@ -2,17 +2,109 @@
 #define __ERROR_HPP_
 
 #include <Arduino.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
+#include "globals.hpp"
 
+// Only a reference is needed here so the game logic that reports errors does not
+//	have to pull in the display library.
+class Adafruit_SSD1306;
+
+
+// Errors
+// REPORT_ERROR(code) keeps the error as a small entry in a ring and carries on, so a
+//	fault never stops the game.  The same error again in a row counts up the entry
+//	rather than pushing the others out.  With LIVE_ERRORS on:
+//		update() shows the latest new error over the score line for bannerShow_ms, at
+//		most once every bannerEvery_ms.
+//		command('E') sends the entries over serial, a line each time round the loop from
+//		poll() so it never waits, and command('C') empties the ring.
+//	With LIVE_ERRORS off REPORT_ERROR() and the rest are nothing.
 
 namespace Error {
 
-//Adafruit_SSD1306* displayPtr;
-void initErrors(Adafruit_SSD1306& display);
-void displayError(int16_t line, const char* file, const char* msg);
-//void displayError(int16_t line, const char* file, const __FlashStringHelper* msg);
+	enum class Code : uint8_t {
+		ErrorState,		// The game got into Game::State::Error.
+		OutOfRange,		// A snake was indexed past its length.
+		BadInsert		// A cell pushed onto a snake was not next to its head.
+	};
+
+	// The files that report errors.  An entry keeps the index of its file in here.
+	constexpr const char* files[] { "main.cpp", "Snake.hpp", "TurnSnake.hpp" };
+	constexpr uint8_t fileCount { sizeof(files) / sizeof(files[0]) };
+	constexpr uint8_t unknownFile { 0xFF };
+
+	constexpr uint8_t Depth { 8 };					// Entries kept.
+	constexpr uint16_t bannerShow_ms { 2000 };
+	constexpr uint16_t bannerEvery_ms { 10000 };
+
+	struct Entry {
+		Code code;
+		uint8_t file;
+		uint16_t line;
+		uint16_t tick;		// The first time.
+		uint8_t count;		// Times in a row, up to 255.
+	};
+
+	constexpr bool endsWith(const char* s, const char* end) {
+		uint16_t a { 0 }, b { 0 };
+		while (s[a] != '\0') ++a;
+		while (end[b] != '\0') ++b;
+		if (b > a) return false;
+		for (uint16_t i { 0 }; i < b; ++i) if (s[a - b + i] != end[i]) return false;
+		return a == b || s[a - b - 1] == '/' || s[a - b - 1] == '\\';
+	}
+
+	// The index in files of a path from __FILE__.  Worked out when compiling.
+	constexpr uint8_t fileId(const char* path) {
+		for (uint8_t i { 0 }; i < fileCount; ++i) if (endsWith(path, files[i])) return i;
+		return unknownFile;
+	}
+	template <uint8_t Id> struct FileId { static constexpr uint8_t value { Id }; };
 
+#if (LIVE_ERRORS == YES)
+	/**
+	 * @brief Keep an error.  Use REPORT_ERROR().  Not from interrupts.
+	 * @param code What went wrong.
+	 * @param file From fileId().
+	 * @param line Where.
+	 */
+	void report(Code code, uint8_t file, uint16_t line);
+
+	void initErrors(Adafruit_SSD1306& display);
+
+	// Count a turn of the game loop for the entries' ticks.
+	void nextTick();
+
+	/**
+	 * @brief Put up or take down the banner.  Call each time round the loop while the score line is showing.
+	 * @return true if the banner has just been taken down and the score line needs drawing again.
+	 */
+	bool update();
+
+	/**
+	 * @brief A command read from serial.  'E' sends the entries and 'C' empties the ring.
+	 * @param c The character.
+	 */
+	void command(char c);
+
+	// Send the next line of the entries if there is one and room for it.  Call each time round the loop.
+	void poll();
+
+	// Errors reported since the start, including those pushed out of the ring.
+	uint16_t total();
+#else
+	inline void initErrors(Adafruit_SSD1306&) {}
+	inline void nextTick() {}
+	inline bool update() { return false; }
+	inline void command(char) {}
+	inline void poll() {}
+	inline uint16_t total() { return 0; }
+#endif
 }
 
-#endif // __ERROR_HPP_
\ No newline at end of file
+#if (LIVE_ERRORS == YES)
+	#define REPORT_ERROR(code) 	Error::report(Error::Code::code, Error::FileId<Error::fileId(__FILE__)>::value, __LINE__)
+#else
+	#define REPORT_ERROR(code)
+#endif
+
+#endif // __ERROR_HPP_
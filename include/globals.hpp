@@ -1,7 +1,6 @@
 #ifndef __GLOBALS_HPP_
 
 #include <Arduino.h>
-#include "Geometry.hpp"
 
 // Defined for readability.
 #define YES 1
@@ -11,32 +10,111 @@
 #define DEBUG NO // or NO
 #define LIVE_ERRORS NO
 
+// Time the main parts of the game on the unit and send the table over serial when
+// asked.  See Profile.hpp.
+#define PROFILE NO
+
+// Debug builds trace what happens each tick as records in RAM, sent over serial between
+// ticks, instead of printing text in the middle of the tick.  See Trace.hpp.
+#if (DEBUG == YES)
+#define TRACE YES
+#else
+#define TRACE NO
+#endif
+
+// After DEBUG so that Point only inherits Printable in debug builds.
+#include "Geometry.hpp"
+
 // Write yes to remove the high score.
 #define CLEAR_HIGH_SCORE NO
 
+// Record each game so that it can be played back on a PC by tools/replay_player.
+// The replay is printed over serial in debug builds and can also be kept in the EEPROM.
+#define RECORD_REPLAY NO
+#define REPLAY_TO_EEPROM NO
+
+// Large board mode for the host and MCUs with more RAM.  Points use 16-bit coordinates,
+// the snake can be as long as the board and the board is set with World::resize() so it
+// can be up to 65535x65535 instead of what fits on the screen.  Can be set from the build
+// flags (-DLARGE_BOARD=YES) as the native_bench_large environment does.
+#ifndef LARGE_BOARD
+#define LARGE_BOARD NO
+#endif
+
+// The game plays itself when started with the middle button, for demos and burn in
+// testing.  It follows a cycle through every cell so it fills the board in the end and
+// starts another game after each one.  See Autopilot.hpp.
+#define AUTOPILOT NO
+#if (AUTOPILOT == YES) && (LARGE_BOARD == YES)
+#error "The autopilot's cycle is for the screen sized world."
+#endif
+
+// The splash screen shows a game played by the autopilot behind the title, drawn with
+// partial updates of the display.  Off for large boards as the autopilot needs the
+// screen sized world.  Else random lines are drawn.
+#if (LARGE_BOARD == YES)
+#define ATTRACT_MODE NO
+#else
+#define ATTRACT_MODE YES
+#endif
+
+// Save the game to the EEPROM when it is paused so that it carries on, still paused,
+// after the power has been off.  See Snapshot.hpp.  Off for large boards.
+#if (LARGE_BOARD == YES)
+#define PAUSE_SNAPSHOT NO
+#else
+#define PAUSE_SNAPSHOT YES
+#endif
+
+// The integer types that count segments of the snake, bytes of its storage and the
+// score, which has to hold scranScore for every cell of the board.
+#if (LARGE_BOARD == YES)
+using SnakeLengthType = uint32_t;
+using SnakeDataSizeType = uint32_t;
+using ScoreType = uint32_t;
+#else
+using SnakeLengthType = uint16_t;
+using SnakeDataSizeType = uint8_t;
+using ScoreType = uint16_t;
+#endif
+
 // This determines the size of the array used to store the snake.  The
 // snake may be 4 times this size + 1 for the head.  Maximum if all spaces 
 // were in the snake would be 160 sections so 40 bytes of data should be enough.
-#if (DEBUG == YES)
-constexpr uint8_t SNAKE_DATA_SIZE { 4 };
-#elif (DEBUG == NO)
-constexpr uint8_t SNAKE_DATA_SIZE { 40 };
+// The memory report printed after each build and Memory::report() show what it
+// costs in RAM and how much is left for the stack.  Debug builds use the same size.
+// In large board mode it is enough for a snake that fills the biggest board.
+#if (LARGE_BOARD == YES)
+constexpr uint32_t LARGE_BOARD_MAX_CELLS { 1UL << 20 };
+constexpr SnakeDataSizeType SNAKE_DATA_SIZE { LARGE_BOARD_MAX_CELLS / 4 };
+#else
+constexpr SnakeDataSizeType SNAKE_DATA_SIZE { 40 };
 #endif
 
+// Bytes of RAM used to record a replay.  Every 16 ticks take 5 bytes so 96 bytes
+// is 272 ticks of moving.  Recording stops when it is full.
+constexpr uint16_t REPLAY_DATA_SIZE { 96 };
+
 // Store Points as a pair of this type.
 // int8_t will give a range of -127 to +128.
 // uint8_t will give a range of 0 to 255.
+// uint16_t will give a range of 0 to 65535 which large board mode uses.
+#if (LARGE_BOARD == YES)
+using POINT_DATA_TYPE = uint16_t;
+#else
 using POINT_DATA_TYPE = uint8_t;
-using PointType = Point<POINT_DATA_TYPE>;
-using SizeType = PointType;
-using Rect = Rectangle<PointType>;
+#endif
+using SizeType = Point<POINT_DATA_TYPE>;
+using Rect = Rectangle<Point<POINT_DATA_TYPE>>;
+// Pixels on the screen.
+using ScreenPoint = Point<uint8_t>;
 
+// Keep the cells of the world in one byte when the world is small enough.  See PointType.
+#define PACK_POINTS YES
 
-// If you want sound. U will need a buzzer.
+
+// If you want sound. U will need a buzzer.  Played in the background from Timer2, see Sound.hpp.
 #define SOUND NO
-#if (SOUND == 0)
-	#define tone(x, y, z)
-#endif
 
 
 // This makes all debugging print statements disappear when DEBUG set to NO.
@@ -57,6 +135,14 @@ using Rect = Rectangle<PointType>;
 	#define DEBUG_PRINTLN_HEX(x)
 #endif // DEBUG
 
+// Adds a Trace record, Trace::Id::id with a 16 bit value.  Nothing when TRACE is off.
+#if (TRACE == YES)
+	#include "Trace.hpp"
+	#define TRACE_EVENT(id, value) 	Trace::add(Trace::Id::id, (value))
+#else
+	#define TRACE_EVENT(id, value)
+#endif // TRACE
+
 
 namespace Utility {
 
@@ -71,6 +157,15 @@ namespace Utility {
 // };
 // #endif // (DEBUG == YES)
 
+#ifdef __AVR__
+// Keeps interrupts out while it is in scope, for changing what an interrupt also uses.
+struct InterruptsOff {
+	const uint8_t sreg { SREG };
+	InterruptsOff() { cli(); }
+	~InterruptsOff() { SREG = sreg; }
+};
+#endif
+
 }
 
 
@@ -84,7 +179,7 @@ namespace Pin {
 	constexpr uint8_t MIDDLE{ 3 };
 
 #if (SOUND == YES)
-	constexpr uint8_t SOUND { 9 };
+	constexpr uint8_t BUZZER { 9 };
 #endif
 }
 
@@ -105,14 +200,48 @@ namespace World {
 	constexpr uint8_t yMinOffset { 12 };
 	constexpr uint8_t yMaxOffset { 2 };
 
-	// How big the world is.
-	constexpr Rect World {
+	// How big the world is on the screen.
+	constexpr Rect ScreenWorld {
 			0,																	// minY
 			0,																	// minX
 			(Display::dspRect.height() - yMinOffset - yMaxOffset) / Scale,		// maxY
 			(Display::dspRect.width() - xMinOffset - xMaxOffset) / Scale 		// maxX
 	};
+
+#if (LARGE_BOARD == YES)
+	// How big the world is.  Starts the same as the screen and is changed with resize().
+	extern Rect World;
+
+	/**
+	 * @brief Change the size of the world.  Reset the game after.
+	 * @return false if it has more than LARGE_BOARD_MAX_CELLS cells and was not changed.
+	 */
+	bool resize(POINT_DATA_TYPE height, POINT_DATA_TYPE width);
+#else
+	// How big the world is.
+	constexpr Rect World { ScreenWorld };
+#endif
+
+	// The number of cells in the world.
+	inline SnakeLengthType cells() { return static_cast<SnakeLengthType>(World.height()) * World.width(); }
+}
+
+
+// A cell of the world.  The 8x20 world only needs 3 bits for the row and 5 for the
+// column so with PACK_POINTS the point is packed in to one byte.  That halves the
+// snake's head and tail, the scran and anything kept per cell and a compare of two
+// points is one compare.  Worlds too big to pack use a pair of POINT_DATA_TYPE.
+// Rect, SizeType and ScreenPoint are never packed as they hold sizes and pixels.
+#if (LARGE_BOARD == NO) && (PACK_POINTS == YES)
+namespace World {
+	constexpr uint8_t yBits { Utility::bitsFor(World.maxY()) };
+	constexpr uint8_t xBits { Utility::bitsFor(World.maxX()) };
 }
+using PointType = typename Utility::SelectType<(World::yBits + World::xBits <= 8),
+					Point<Packed<World::yBits>>, Point<POINT_DATA_TYPE>>::type;
+#else
+using PointType = Point<POINT_DATA_TYPE>;
+#endif
 
 
 // All the directions you need.
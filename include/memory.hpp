@@ -0,0 +1,30 @@
+#ifndef __MEMORY_HPP_
+#define __MEMORY_HPP_
+
+#include <Arduino.h>
+
+// Stack painting.
+// Before any constructors run the free RAM between the end of .bss and the top of the
+//	stack is filled with a known byte.  The stack only ever overwrites it so counting
+//	how much of the pattern is left shows the most stack the program has ever used.
+//	Together with the memory report printed after each build this tells us how close
+//	to the 2 KB the Uno is.  On the host these all return 0.
+
+namespace Memory {
+
+	constexpr uint8_t paintByte { 0xC5 };
+
+	// Bytes of painted RAM the stack has never reached.
+	uint16_t stackUnused();
+
+	// The most stack used so far in bytes.
+	uint16_t stackHighWaterMark();
+
+	// Bytes between the top of the heap and the stack pointer now.
+	uint16_t freeRam();
+
+	// Print a one line summary e.g. "MEM stack_max=312 stack_unused=190 free=402".
+	void report(Print& p);
+}
+
+#endif // __MEMORY_HPP_
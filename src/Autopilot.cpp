@@ -0,0 +1,117 @@
+#include "Autopilot.hpp"
+#include "CycleCounter.hpp"
+
+// The cycle is for the screen sized world.  Large boards are sized at run time.
+#if (LARGE_BOARD == NO)
+
+namespace {
+
+	constexpr uint8_t Height { World::ScreenWorld.height() };
+	constexpr uint8_t Width { World::ScreenWorld.width() };
+	constexpr uint16_t Cells { Height * Width };
+
+	static_assert(Cells <= 256, "A cell's place on the cycle has to fit in a byte.");
+	static_assert(Height % 2 == 0, "The cycle needs an even number of rows.");
+
+	struct Cycle {
+		uint8_t index[Cells];	// Place on the cycle of cell y * Width + x.
+	};
+
+	// Row 0 runs right.  The odd rows run left to column 1 then down, apart from the last
+	//	which runs on to column 0.  The even rows run right then down.  Column 0 runs up.
+	//
+	//		>>>>>>>v
+	//		^v<<<<<<
+	//		^>>>>>>v
+	//		^<<<<<<<
+	constexpr Cycle makeCycle() {
+		Cycle c {};
+		uint8_t y { 0 }, x { 0 };
+		for (uint16_t i { 0 }; i < Cells; ++i) {
+			c.index[y * Width + x] = static_cast<uint8_t>(i);
+			if (x == 0) { if (y == 0) ++x; else --y; }
+			else if (y % 2 == 1) { if (x > 1 || y == Height - 1) --x; else ++y; }
+			else { if (x < Width - 1) ++x; else ++y; }
+		}
+		return c;
+	}
+
+	constexpr Cycle cycle PROGMEM { makeCycle() };
+
+	constexpr Direction directions[] { Direction::UP, Direction::LEFT, Direction::RIGHT, Direction::DOWN };
+
+	uint16_t last { 0 };
+	uint16_t worst { 0 };
+
+	constexpr uint16_t noBudget { 0xFFFF };
+}
+
+
+namespace Autopilot {
+
+#if (AUTOPILOT == YES)
+	bool enabled { false };
+#endif
+
+	uint8_t cycleIndex(const PointType& p) {
+		return pgm_read_byte(&cycle.index[p.y * Width + p.x]);
+	}
+
+	Direction decide(const GameCore& game) { return decide(game, noBudget); }
+
+	Direction decide(const GameCore& game, uint16_t budget_cycles) {
+
+		const CycleCounter timer {};
+		const auto& snake { game.snake() };
+		const PointType& head { snake.head() };
+		const uint8_t h { cycleIndex(head) };
+
+		// How far along the cycle i is from the head.  No % as dividing is slow on the avr.
+		auto ahead { [h](uint8_t i) -> uint16_t { return (i >= h) ? i - h : i + Cells - h; } };
+
+		// The cells before the tail are free.  A one segment snake has all of them.
+		const uint16_t room { (snake.length() == 1) ? Cells : ahead(cycleIndex(snake.tail())) };
+		const uint16_t toScran { ahead(cycleIndex(game.scran())) };
+
+		Direction best { Direction::NONE };
+		uint16_t bestStep { 0 };
+		for (const auto d : directions) {
+
+			// Any move taken is safe, so once there is one the budget can end the search.
+			if (best != Direction::NONE && budget_cycles != noBudget && timer.cycles() >= budget_cycles) break;
+
+			// step() ignores going back the way it came.
+			if (d == ~game.direction()) continue;
+			if (game.detectPlayerOutOfArea(head, d)) continue;
+
+			// The next cell on the cycle is always safe.  Else only cut across to a cell
+			//	before the tail and not past the scran.
+			const uint16_t step { ahead(cycleIndex(movePoint(head, d))) };
+			if (step != 1 && (step >= room || step > toScran)) continue;
+			if (step > bestStep) { best = d; bestStep = step; }
+		}
+
+		// Only a one segment snake whose next cell is behind it gets here with nothing.
+		//	It has nothing to hit so any way that stays in the world is fine.
+		if (best == Direction::NONE) {
+			for (const auto d : directions) {
+				if (d != ~game.direction() && !game.detectPlayerOutOfArea(head, d)) { best = d; break; }
+			}
+		}
+
+		return best;
+	}
+
+	Direction nextDirection(const GameCore& game) {
+		const CycleCounter timer {};
+		const Direction d { decide(game) };
+		last = timer.cycles();
+		if (last > worst) worst = last;
+		return d;
+	}
+
+	uint16_t lastCycles() { return last; }
+	uint16_t worstCycles() { return worst; }
+}
+
+#endif // (LARGE_BOARD == NO)
@@ -0,0 +1,88 @@
+#include "DirtyPages.hpp"
+#ifdef __AVR__
+#include <Wire.h>
+#endif
+
+namespace {
+
+	// The avr's Wire buffer is 32 bytes and the first of each data transmission is the
+	//	control byte.
+	constexpr uint8_t chunk { 31 };
+
+	constexpr uint8_t commandStream { 0x00 };
+	constexpr uint8_t dataStream { 0x40 };
+
+#ifdef __AVR__
+	// The I2C clock while sending and after, as display() has them.
+	constexpr uint32_t clockDuring { 400000UL };
+	constexpr uint32_t clockAfter { 100000UL };
+#endif
+}
+
+
+void DirtyPages::forget() {
+	for (uint8_t page { 0 }; page < Pages; ++page) {
+		m_first[page] = Columns;
+		m_last[page] = 0;
+	}
+}
+
+
+void DirtyPages::mark(int16_t x, int16_t y, int16_t w, int16_t h) {
+
+	if (x < 0) { w += x; x = 0; }
+	if (y < 0) { h += y; y = 0; }
+	if (x + w > Columns) w = Columns - x;
+	if (y + h > Pages * 8) h = Pages * 8 - y;
+	if (w <= 0 || h <= 0) return;
+
+	const uint8_t first { static_cast<uint8_t>(x) }, last { static_cast<uint8_t>(x + w - 1) };
+	for (uint8_t page { static_cast<uint8_t>(y / 8) }; page <= (y + h - 1) / 8; ++page) {
+		if (first < m_first[page]) m_first[page] = first;
+		if (last > m_last[page]) m_last[page] = last;
+	}
+}
+
+
+void DirtyPages::flush(Adafruit_SSD1306& display) {
+
+	const uint8_t* buffer { display.getBuffer() };
+#ifdef __AVR__
+	Wire.setClock(clockDuring);
+#endif
+
+	for (uint8_t page { 0 }; page < Pages; ++page) {
+
+		if (m_first[page] > m_last[page]) continue;
+		const uint8_t first { m_first[page] }, last { m_last[page] };
+
+		// The window to write in, in one transmission.
+		const uint8_t window[] { commandStream, SSD1306_PAGEADDR, page, page, SSD1306_COLUMNADDR, first, last };
+#ifdef __AVR__
+		Wire.beginTransmission(Display::Address);
+		Wire.write(window, sizeof(window));
+		Wire.endTransmission();
+#endif
+		m_bytes += 1 + sizeof(window);
+
+		// Then the columns a Wire buffer at a time.
+		const uint8_t* data { buffer + page * Columns + first };
+		for (uint8_t left { static_cast<uint8_t>(last - first + 1) }; left > 0; ) {
+			const uint8_t n { (left < chunk) ? left : chunk };
+#ifdef __AVR__
+			Wire.beginTransmission(Display::Address);
+			Wire.write(dataStream);
+			Wire.write(data, n);
+			Wire.endTransmission();
+#endif
+			m_bytes += 2 + n;
+			data += n;
+			left -= n;
+		}
+	}
+
+#ifdef __AVR__
+	Wire.setClock(clockAfter);
+#endif
+	forget();
+}
@@ -0,0 +1,149 @@
+#include <EEPROM.h>
+#include "EepromWriter.hpp"
+#include "globals.hpp"
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#endif
+
+namespace {
+
+	using namespace EepromWriter;
+
+	static_assert((Depth & (Depth - 1)) == 0 && Depth <= 128, "The queue depth has to be a power of 2 up to 128.");
+
+	Counters counts {};
+
+#ifdef __AVR__
+	constexpr uint8_t mask { Depth - 1 };
+
+	// update() adds at tail and the interrupt takes from head.  Both count up and wrap
+	//	so tail - head is the number queued.
+	volatile uint16_t addresses[Depth];
+	volatile uint8_t values[Depth];
+	volatile uint8_t head { 0 };
+	volatile uint8_t tail { 0 };
+
+	uint8_t size() { return static_cast<uint8_t>(tail - head); }
+
+	using Utility::InterruptsOff;
+
+	// Where address is in the queue, counting like head and tail, or tail if it is not.
+	//	With interrupts off.
+	uint8_t find(uint16_t address) {
+		uint8_t i { head };
+		while (i != tail && addresses[i & mask] != address) ++i;
+		return i;
+	}
+
+	// Take out the entry at i, moving the ones after it up.  With interrupts off.
+	void drop(uint8_t i) {
+		for (uint8_t next { static_cast<uint8_t>(i + 1) }; next != tail; ++i, ++next) {
+			addresses[i & mask] = addresses[next & mask];
+			values[i & mask] = values[next & mask];
+		}
+		tail = tail - 1;
+	}
+#endif
+}
+
+
+#ifdef __AVR__
+// Ready for the next byte.  Write the next one that does not already hold its value or,
+//	if there is none, turn the interrupt off.  The test is done here as the EEPROM is
+//	known to be free.
+ISR(EE_READY_vect) {
+	while (head != tail) {
+		const uint8_t i { static_cast<uint8_t>(head & mask) };
+		head = head + 1;
+		EEAR = addresses[i];
+		EECR |= _BV(EERE);
+		if (EEDR == values[i]) {
+			++counts.skipped;
+			continue;
+		}
+		EEDR = values[i];
+		EECR |= _BV(EEMPE);		// EEPE has to be set within 4 cycles of this.
+		EECR |= _BV(EEPE);
+		return;
+	}
+	EECR &= ~_BV(EERIE);
+}
+#endif
+
+
+namespace EepromWriter {
+
+	void update(uint16_t address, uint8_t value) {
+
+#ifdef __AVR__
+		{
+			// A new value for a queued byte goes to the back so the bytes land in the
+			//	order of their last update().
+			const InterruptsOff off {};
+			const uint8_t queued { find(address) };
+			if (queued != tail) {
+				drop(queued);
+				++counts.skipped;
+			}
+		}
+
+		if (size() == Depth) {
+			const auto start { micros() };
+			while (size() == Depth) {}
+			counts.stall_us += micros() - start;
+		}
+
+		const InterruptsOff off {};
+		addresses[tail & mask] = address;
+		values[tail & mask] = value;
+		tail = tail + 1;
+		if (size() > counts.deepest) counts.deepest = size();
+		EECR |= _BV(EERIE);
+#else
+		if (EEPROM.read(address) == value) { ++counts.skipped; return; }
+		EEPROM.write(address, value);
+		counts.deepest = 1;
+#endif
+		++counts.queued;
+	}
+
+	uint8_t read(uint16_t address) {
+#ifdef __AVR__
+		{
+			const InterruptsOff off {};
+			const uint8_t queued { find(address) };
+			if (queued != tail) return values[queued & mask];
+			// Otherwise the interrupt could start the next write between EEPROM.read()
+			//	waiting for the last one and setting the address.
+			EECR &= ~_BV(EERIE);
+		}
+		if (EECR & _BV(EEPE)) {
+			const auto start { micros() };
+			while (EECR & _BV(EEPE)) {}
+			counts.stall_us += micros() - start;
+		}
+		const uint8_t value { EEPROM.read(address) };
+		if (size() != 0) EECR |= _BV(EERIE);
+		return value;
+#else
+		return EEPROM.read(address);
+#endif
+	}
+
+	bool idle() {
+#ifdef __AVR__
+		return size() == 0 && (EECR & _BV(EEPE)) == 0;
+#else
+		return true;
+#endif
+	}
+
+	void flush() {
+		if (idle()) return;
+		const auto start { micros() };
+		while (!idle()) {}
+		counts.stall_us += micros() - start;
+	}
+
+	const Counters& counters() { return counts; }
+}
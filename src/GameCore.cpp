@@ -0,0 +1,179 @@
+#include "GameCore.hpp"
+#include "Profile.hpp"
+
+constexpr uint16_t GameCore::updateTimeOnReset_ms;
+constexpr uint8_t GameCore::scranScore;
+constexpr uint16_t GameCore::speedUpEvery;
+constexpr uint8_t GameCore::speedUpDivisor;
+
+
+void GameCore::reset(uint32_t seed, uint8_t level) {
+
+	setLevel(level);
+	m_random = Random { seed };
+	m_snake = SnakeType { }; 				// Create a new empty snake.
+	m_snake.push( getRandomPoint() ); 		// Put the snake in a random place.
+
+	m_score = 0;							// Reset the score.
+	m_updateTime_ms = updateTimeOnReset_ms;	// Reset game speed.
+
+	placeRandomScran();						// Place the food.
+}
+
+
+GameEvents GameCore::step(Direction input) {
+
+// Current order of events.
+// 1. - If direction is changed then change direction.
+// 2. - If snake moving then determine new head position.
+// 3. - Detect if out of area, into a wall or self collision.  If not add a new head.
+// 4. - Detect if the player ate scran.
+// 5. - If scran eaten then update the score and replace the scran. else pop the tail.
+
+	GameEvents events {};
+
+// Update the Snake's direction from button input if not same or opposite direction.
+	if (input <= Direction::DOWN && input != m_snake.getDirection() && input != ~m_snake.getDirection())
+		m_snake.setDirection(input);
+
+// If the snake is not moving there is nothing to do.
+	if (m_snake.getDirection() == Direction::NONE) return events;
+
+	if (detectPlayerOutOfArea(m_snake.head(), m_snake.getDirection())) {
+		TRACE_EVENT(HitWall, Trace::cell(m_snake.head()));
+		events.flags |= GameEvents::HitWall;
+		return events;
+	}
+
+	const auto newHead { movePoint(m_snake.head(), m_snake.getDirection()) };
+	if (detectWall(newHead)) {
+		TRACE_EVENT(HitWall, Trace::cell(newHead));
+		events.flags |= GameEvents::HitWall;
+		return events;
+	}
+	if (detectSelfCollision(newHead)) {
+		TRACE_EVENT(HitSelf, Trace::cell(newHead));
+		events.flags |= GameEvents::HitSelf;
+		return events;
+	}
+
+	m_snake.push(newHead);
+	TRACE_EVENT(Moved, Trace::cell(newHead));
+	events.flags |= GameEvents::Moved;
+	events.head = newHead;
+
+	if (detectPlayerAteScran()) { // If eating tail stays put and only head advances.
+
+		events.flags |= GameEvents::Ate;
+		m_score += scranScore;
+		TRACE_EVENT(Ate, m_score);
+
+		if (m_score % speedUpEvery == 0) {
+			m_updateTime_ms -= (m_updateTime_ms / speedUpDivisor);
+			events.flags |= GameEvents::SpeedUp;
+		}
+		if (!placeRandomScran()) events.flags |= GameEvents::Won;
+	}
+	else {
+		events.removedTail = m_snake.pop();
+		TRACE_EVENT(Tail, Trace::cell(events.removedTail));
+	}
+
+	return events;
+}
+
+
+uint8_t GameCore::checksum() const {
+
+	uint8_t c { 0 };
+	auto mix { [&c](uint8_t b) { c = static_cast<uint8_t>(((c << 1) | (c >> 7)) ^ b); } };
+
+	// Only the low byte of each coordinate unless they are wider, and the low 16 bits of
+	//	the length and score unless they are longer, so small boards keep the same
+	//	checksums in large board builds.
+	auto mixPoint { [&mix](const PointType& p) {
+		mix(static_cast<uint8_t>(p.y)); mix(static_cast<uint8_t>(p.x));
+		if (sizeof(POINT_DATA_TYPE) > 1 && ((p.y | p.x) >> 8) != 0) {
+			mix(static_cast<uint8_t>(p.y >> 8)); mix(static_cast<uint8_t>(p.x >> 8));
+		}
+	} };
+
+	mixPoint(m_snake.head());
+	mixPoint(m_snake.tail());
+	mix(static_cast<uint8_t>(m_snake.length())); mix(static_cast<uint8_t>(m_snake.length() >> 8));
+#if (LARGE_BOARD == YES)
+	if ((m_snake.length() >> 16) != 0) { mix(static_cast<uint8_t>(m_snake.length() >> 16)); mix(static_cast<uint8_t>(m_snake.length() >> 24)); }
+#endif
+	mixPoint(m_scran);
+	mix(static_cast<uint8_t>(m_score)); mix(static_cast<uint8_t>(m_score >> 8));
+#if (LARGE_BOARD == YES)
+	if ((m_score >> 16) != 0) { mix(static_cast<uint8_t>(m_score >> 16)); mix(static_cast<uint8_t>(m_score >> 24)); }
+#endif
+	for (uint8_t i { 0 }; i < 32; i += 8) mix(static_cast<uint8_t>(m_random.state >> i));
+	if (m_level != 0) mix(m_level);		// So open games keep the checksums they had.
+	return c;
+}
+
+
+void GameCore::setLevel(uint8_t level) {
+
+#if (LARGE_BOARD == YES)
+	(void)level;
+	m_level = 0;			// Levels are for the screen sized world.
+#else
+	m_level = (level < Levels::count) ? level : 0;
+#endif
+	m_walls = Levels::walls(m_level);
+}
+
+
+bool GameCore::placeRandomScran() {
+
+	PROFILE_ZONE(PlaceScran);
+	const SnakeLengthType cells { (m_walls != nullptr) ? SnakeLengthType { Levels::freeCells(m_level) } : World::cells() };
+	if (m_snake.length() >= cells) return false;
+
+	do {
+		m_scran = getRandomPoint();
+	} while (m_snake.pointIsInside(m_scran));
+	TRACE_EVENT(Scran, Trace::cell(m_scran));
+
+	return true;
+}
+
+
+// A cell that is not a wall.  Levels with walls pick one of their free cells so there
+//	is no trying again for walls.
+PointType GameCore::getRandomPoint() {
+
+	if (m_walls != nullptr) return Levels::freeCell(m_level, static_cast<uint8_t>(m_random.below(Levels::freeCells(m_level))));
+
+	using World::World;
+	return { static_cast<POINT_DATA_TYPE>( World.minY() + m_random.below(World.height()) ),
+			 static_cast<POINT_DATA_TYPE>( World.minX() + m_random.below(World.width()) ) };
+}
+
+
+bool GameCore::detectSelfCollision(const PointType& newHead) const {
+
+	auto hasCollided { m_snake.pointIsInside(newHead) };
+
+	return hasCollided && hasCollided.getValue() != m_snake.tail();
+}
+
+
+bool GameCore::detectPlayerOutOfArea(const PointType& head, Direction direction) const {
+
+	using World::World;
+
+	bool rVal;
+	switch (direction) {
+		case Direction::UP: 	rVal = ( head.y <= World.minY() ); break;
+		case Direction::DOWN: 	rVal = ( head.y + 1 >= World.maxY() ); break;
+		case Direction::LEFT: 	rVal = ( head.x <= World.minX() ); break;
+		case Direction::RIGHT: 	rVal = ( head.x + 1 >= World.maxX() ); break;
+		default: 				rVal = false;
+	}
+
+	return rVal;
+}
@@ -0,0 +1,139 @@
+#include "HighScores.hpp"
+#include "EepromLayout.hpp"
+#include "EepromWriter.hpp"
+#include "Crc8.hpp"
+
+namespace {
+
+	using namespace HighScores;
+
+	constexpr uint8_t Slots { EepromLayout::highScoresSize / recordSize };
+	constexpr uint16_t noSequence { 0xFFFF };
+	constexpr uint16_t sequences { 0xFFFF };	// 0 to 0xFFFE.
+
+	static_assert(Slots >= 2, "The high score ring needs at least two slots.");
+
+	uint16_t scores[Entries] {};
+	uint8_t latest { Slots - 1 };			// So the first record goes in slot 0.
+	uint16_t sequence { noSequence };		// Of the latest record.  noSequence if none.
+
+	uint16_t address(uint8_t slot) { return EepromLayout::highScores + slot * recordSize; }
+
+	uint16_t readWord(uint16_t at) { return static_cast<uint16_t>(EepromWriter::read(at) | (EepromWriter::read(at + 1) << 8)); }
+
+	uint16_t sequenceAt(uint8_t slot) { return readWord(address(slot)); }
+
+	// The sequence n records after s.
+	uint16_t after(uint16_t s, uint8_t n) { return static_cast<uint16_t>((static_cast<uint32_t>(s) + n) % sequences); }
+
+	// True if a was written after b.  Sequences go round so half of them are ahead.
+	bool newer(uint16_t a, uint16_t b) {
+		const uint16_t ahead { static_cast<uint16_t>((static_cast<uint32_t>(a) + sequences - b) % sequences) };
+		return ahead != 0 && ahead < sequences / 2;
+	}
+
+	bool valid(uint8_t slot) {
+		const uint16_t at { address(slot) };
+		if (readWord(at) == noSequence) return false;
+		uint8_t c { 0 };
+		for (uint8_t i { 0 }; i < recordSize - 1; ++i) c = Utility::crc8(c, EepromWriter::read(at + i));
+		return c == EepromWriter::read(at + recordSize - 1);
+	}
+
+	void use(uint8_t slot) {
+		latest = slot;
+		sequence = sequenceAt(slot);
+		for (uint8_t i { 0 }; i < Entries; ++i) scores[i] = readWord(address(slot) + 2 + 2 * i);
+	}
+
+	// The latest record if slot 0 is good.  Slots 0 to latest carry on from slot 0's
+	//	sequence and the rest are older or erased.
+	bool findFromSlot0() {
+		if (!valid(0)) return false;
+		const uint16_t first { sequenceAt(0) };
+		uint8_t low { 0 }, high { Slots - 1 };
+		while (low < high) {
+			const uint8_t middle { static_cast<uint8_t>((low + high + 1) / 2) };
+			if (sequenceAt(middle) == after(first, middle)) low = middle;
+			else high = static_cast<uint8_t>(middle - 1);
+		}
+		while (!valid(low)) --low;		// Cut off while being written.  Ends at slot 0.
+		use(low);
+		return true;
+	}
+
+	// Every slot for the newest good record.
+	bool findByScanning() {
+		bool found { false };
+		for (uint8_t slot { 0 }; slot < Slots; ++slot) {
+			if (!valid(slot)) continue;
+			if (!found || newer(sequenceAt(slot), sequence)) use(slot);
+			found = true;
+		}
+		return found;
+	}
+
+	// Write the table as a new record in the next slot.  The sequence goes last so a
+	//	record cut off part way is not taken for the latest.
+	void save() {
+		const uint8_t slot { static_cast<uint8_t>((latest + 1) % Slots) };
+		const uint16_t s { (sequence == noSequence) ? uint16_t { 0 } : after(sequence, 1) };
+		const uint16_t at { address(slot) };
+
+		uint8_t record[recordSize];
+		record[0] = static_cast<uint8_t>(s);
+		record[1] = static_cast<uint8_t>(s >> 8);
+		for (uint8_t i { 0 }; i < Entries; ++i) {
+			record[2 + 2 * i] = static_cast<uint8_t>(scores[i]);
+			record[3 + 2 * i] = static_cast<uint8_t>(scores[i] >> 8);
+		}
+		uint8_t c { 0 };
+		for (uint8_t i { 0 }; i < recordSize - 1; ++i) c = Utility::crc8(c, record[i]);
+		record[recordSize - 1] = c;
+
+		for (uint8_t i { 2 }; i < recordSize; ++i) EepromWriter::update(at + i, record[i]);
+		EepromWriter::update(at, record[0]);
+		EepromWriter::update(at + 1, record[1]);
+
+		latest = slot;
+		sequence = s;
+	}
+}
+
+
+namespace HighScores {
+
+	void load() {
+
+		for (auto& s : scores) s = 0;
+		latest = Slots - 1;
+		sequence = noSequence;
+		if (findFromSlot0() || findByScanning()) return;
+
+		// No table yet.  Start one with the old high score if there is one.
+		const uint8_t old { EepromWriter::read(EepromLayout::highScore) };
+		if (old != 0xFF && old != 0) {
+			scores[0] = static_cast<uint16_t>(old * 10);
+			save();
+		}
+	}
+
+	uint16_t score(uint8_t place) { return (place < Entries) ? scores[place] : 0; }
+
+	uint8_t add(uint16_t score) {
+
+		uint8_t place { 0 };
+		while (place < Entries && scores[place] >= score) ++place;
+		if (place == Entries) return Entries;
+
+		for (uint8_t i { Entries - 1 }; i > place; --i) scores[i] = scores[i - 1];
+		scores[place] = score;
+		save();
+		return place;
+	}
+
+	void clear() {
+		for (auto& s : scores) s = 0;
+		save();
+	}
+}
@@ -0,0 +1,61 @@
+// Made by tools/make_levels.py from the maps in levels/.  Do not edit.
+#include "Levels.hpp"
+
+namespace {
+
+	const char openName[] PROGMEM { "open" };
+
+	// pillars from 1_pillars.txt
+	//	....................
+	//	....................
+	//	...##....##....##...
+	//	....................
+	//	....................
+	//	...##....##....##...
+	//	....................
+	//	....................
+	const uint8_t walls1[] PROGMEM { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x86, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x86, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	const uint8_t rows1[] PROGMEM { 0, 20, 40, 54, 74, 94, 108, 128 };
+	const char name1[] PROGMEM { "pillars" };
+
+	// rooms from 2_rooms.txt
+	//	....................
+	//	.........#..........
+	//	.........#..........
+	//	.........#..........
+	//	..........#.........
+	//	..........#.........
+	//	..........#.........
+	//	....................
+	const uint8_t walls2[] PROGMEM { 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x02, 0x00, 0x00, 0x02, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00 };
+	const uint8_t rows2[] PROGMEM { 0, 20, 39, 58, 77, 96, 115, 134 };
+	const char name2[] PROGMEM { "rooms" };
+
+	// bars from 3_bars.pbm
+	//	....................
+	//	....############....
+	//	....................
+	//	....................
+	//	....................
+	//	....................
+	//	....############....
+	//	....................
+	const uint8_t walls3[] PROGMEM { 0x00, 0x00, 0x00, 0xF0, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xFF, 0x00, 0x00, 0x00, 0x00 };
+	const uint8_t rows3[] PROGMEM { 0, 20, 28, 48, 68, 88, 108, 116 };
+	const char name3[] PROGMEM { "bars" };
+
+	static_assert(Levels::Height == 8 && Levels::Width == 20, "Run tools/make_levels.py again for this size of world.");
+}
+
+
+namespace Levels {
+
+	const Level table[] PROGMEM {
+		{ nullptr, nullptr, Cells, openName },
+		{ walls1, rows1, 148, name1 },
+		{ walls2, rows2, 154, name2 },
+		{ walls3, rows3, 136, name3 },
+	};
+
+	const uint8_t count { sizeof(table) / sizeof(table[0]) };
+}
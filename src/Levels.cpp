@@ -0,0 +1,27 @@
+#include "Levels.hpp"
+
+namespace Levels {
+
+	PointType freeCell(uint8_t level, uint8_t n) {
+
+		const uint8_t* rows { static_cast<const uint8_t*>(pgm_read_ptr(&table[level].rows)) };
+		const uint8_t* walls { Levels::walls(level) };
+
+		uint8_t y { Height - 1 };
+		while (y > 0 && pgm_read_byte(rows + y) > n) --y;
+		n -= pgm_read_byte(rows + y);
+
+		// The n-th clear bit of the row.
+		const uint8_t* row { walls + y * RowBytes };
+		uint8_t x { 0 };
+		for (uint8_t i { 0 }; i < RowBytes; ++i) {
+			uint8_t bits { pgm_read_byte(row + i) };
+			for (uint8_t b { 0 }; b < 8 && x < Width; ++b, ++x, bits >>= 1) {
+				if (bits & 1) continue;
+				if (n == 0) return { static_cast<POINT_DATA_TYPE>(y), static_cast<POINT_DATA_TYPE>(x) };
+				--n;
+			}
+		}
+		return {};		// Not reached for n less than freeCells(level).
+	}
+}
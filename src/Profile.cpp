@@ -0,0 +1,106 @@
+#include "Profile.hpp"
+
+#if (PROFILE == YES)
+
+#include "CycleCounter.hpp"
+
+namespace {
+
+	using namespace Profile;
+
+	constexpr uint8_t zones { static_cast<uint8_t>(Zone::Count) };
+	constexpr uint8_t lineSize { 56 };		// The longest line of the table.
+
+	Stats table[zones] {};
+	volatile uint32_t milliseconds { 0 };	// Timer1 interrupts.
+	uint8_t sending { 0 };					// Lines of the table left to send.
+
+	const __FlashStringHelper* name(Zone zone) {
+		switch (zone) {
+			case Zone::UpdateGame: 	return F("updateGame");
+			case Zone::DrawSnake: 	return F("drawSnake");
+			case Zone::Display: 	return F("display");
+			case Zone::PlaceScran: 	return F("placeScran");
+			case Zone::ReadButtons: return F("readButtons");
+			case Zone::GameOver: 	return F("gameOver");
+			case Zone::Demo: 		return F("demo");
+			case Zone::Flash: 		return F("flash");
+			case Zone::Boxes: 		return F("boxes");
+			case Zone::Wipe: 		return F("wipe");
+			case Zone::HighScore: 	return F("highScore");
+			default: 				return F("?");
+		}
+	}
+
+	void clear() {
+#ifdef __AVR__
+		const Utility::InterruptsOff off {};
+#endif
+		for (auto& s : table) s = {};
+	}
+}
+
+
+namespace Profile {
+
+	uint32_t now() {
+#ifdef __AVR__
+		const Utility::InterruptsOff off {};
+		const uint16_t t { TCNT1 };
+		uint32_t ms { milliseconds };
+		// Gone round since the interrupt last ran.  It will count it once they are back on.
+		if ((TIFR1 & _BV(OCF1A)) && t < (OCR1A >> 1)) ++ms;
+		return (ms * (OCR1A + 1UL) + t) * CycleCounter::prescaler();
+#else
+		return static_cast<uint32_t>(micros() * 16);
+#endif
+	}
+
+	void add(Zone zone, uint32_t cycles) {
+		Stats& s { table[static_cast<uint8_t>(zone)] };
+		if (s.count == 0xFFFF || s.total + cycles < s.total) {
+			s.count /= 2;
+			s.total /= 2;
+		}
+		++s.count;
+		s.total += cycles;
+		if (s.count == 1 || cycles < s.least) s.least = cycles;
+		if (cycles > s.most) s.most = cycles;
+	}
+
+	void timerTick() { milliseconds = milliseconds + 1; }
+
+	void command(char c) {
+		if (c == 'R' || c == 'r') clear();
+		else if (c == 'P' || c == 'p') sending = zones + 1;
+	}
+
+	void poll() {
+
+		if (sending == 0 || Serial.availableForWrite() < lineSize) return;
+
+		// The header line and then the zones in order.
+		if (sending == zones + 1) Serial.println(F("PROFILE zone count least most mean (cycles)"));
+		else {
+			const Zone zone { static_cast<Zone>(zones - sending) };
+			Stats s;
+			{
+#ifdef __AVR__
+				const Utility::InterruptsOff off {};	// ReadButtons changes in its interrupt.
+#endif
+				s = table[static_cast<uint8_t>(zone)];
+			}
+			Serial.print(name(zone)); Serial.print(' ');
+			Serial.print(s.count); Serial.print(' ');
+			if (s.count == 0) Serial.println(F("- - -"));
+			else {
+				Serial.print(s.least); Serial.print(' ');
+				Serial.print(s.most); Serial.print(' ');
+				Serial.println(s.total / s.count);
+			}
+		}
+		--sending;
+	}
+}
+
+#endif // (PROFILE == YES)
@@ -0,0 +1,148 @@
+#include "Snapshot.hpp"
+#include "EepromLayout.hpp"
+#include "EepromWriter.hpp"
+#include "Crc8.hpp"
+
+// Cells are kept in a byte so it is for the screen sized world.
+#if (PAUSE_SNAPSHOT == YES)
+
+namespace {
+
+	using namespace Snapshot;
+
+	constexpr uint8_t magic { 'P' };
+
+	static_assert(World::World.height() * World::World.width() <= 256, "A cell has to fit in a byte.");
+	static_assert(sizeFor(1 + SNAKE_DATA_SIZE * 4) <= EepromLayout::snapshotSize, "The longest snake does not fit in the snapshot.");
+
+	uint8_t cell(const PointType& p) { return static_cast<uint8_t>(p.y * World::World.width() + p.x); }
+
+	PointType point(uint8_t cell) {
+		return { static_cast<POINT_DATA_TYPE>(cell / World::World.width()), static_cast<POINT_DATA_TYPE>(cell % World::World.width()) };
+	}
+
+	bool inside(uint8_t cell) { return cell < World::cells(); }
+
+	// The way from a to the next cell b.
+	Direction step(const PointType& a, const PointType& b) {
+		if (b.y != a.y) return (b.y > a.y) ? Direction::DOWN : Direction::UP;
+		return (b.x > a.x) ? Direction::RIGHT : Direction::LEFT;
+	}
+
+	uint8_t read(uint8_t i) { return EepromWriter::read(EepromLayout::snapshot + i); }
+
+	// Queues a snapshot after the 'P', keeping its CRC, and then the 'P'.
+	class Writer {
+		uint8_t m_at { 1 };
+		uint8_t m_crc { Utility::crc8(0, magic) };
+		uint8_t m_crumbs { 0 };
+		uint8_t m_crumbCount { 0 };
+	public:
+		void put(uint8_t b) {
+			m_crc = Utility::crc8(m_crc, b);
+			EepromWriter::update(EepromLayout::snapshot + m_at++, b);
+		}
+		void put16(uint16_t w) {
+			put(static_cast<uint8_t>(w));
+			put(static_cast<uint8_t>(w >> 8));
+		}
+		// Packed 4 to a byte, first in the top bits, like CrumbPtr.
+		void putCrumb(Direction d) {
+			m_crumbs = static_cast<uint8_t>((m_crumbs << 2) | static_cast<uint8_t>(d));
+			if (++m_crumbCount == 4) {
+				put(m_crumbs);
+				m_crumbCount = 0;
+			}
+		}
+		// The bytes in the snapshot.
+		uint8_t finish() {
+			if (m_crumbCount != 0) put(static_cast<uint8_t>(m_crumbs << (2 * (4 - m_crumbCount))));
+			EepromWriter::update(EepromLayout::snapshot + m_at, m_crc);
+			EepromWriter::update(EepromLayout::snapshot, magic);
+			return static_cast<uint8_t>(m_at + 1);
+		}
+	};
+}
+
+
+namespace Snapshot {
+
+	uint8_t save(const GameCore& game) {
+
+		// Clear the 'P' and wait for it first, so a cut while the rest is written leaves
+		//	no snapshot rather than the last one's header over a half written body.
+		EepromWriter::update(EepromLayout::snapshot, 0xFF);
+		EepromWriter::flush();
+
+		const SnakeType& snake { game.snake() };
+		const uint16_t score { game.score() }, time { game.updateTime_ms() };
+		const uint32_t state { game.random().state };
+
+		// Queued straight from the game a byte at a time rather than built in a buffer,
+		//	as it is called deep in the pause with little stack left.
+		Writer out {};
+		out.put(version);
+		out.put(static_cast<uint8_t>(snake.length()));
+		out.put(cell(snake.tail()));
+		out.put(static_cast<uint8_t>(game.direction()));
+		out.put(cell(game.scran()));
+		out.put16(score);
+		out.put16(time);
+		out.put16(static_cast<uint16_t>(state));
+		out.put16(static_cast<uint16_t>(state >> 16));
+		out.put(game.level());
+
+		PointType last { snake.tail() };
+		for (SnakeType::Walker w { snake }; w.next(), !w.done(); ) {
+			out.putCrumb(step(last, w.point()));
+			last = w.point();
+		}
+		return out.finish();
+	}
+
+	bool restore(GameCore& game) {
+
+		if (read(0) != magic || read(1) != version) return false;
+		const uint8_t length { read(2) };
+		if (length == 0 || sizeFor(length) > EepromLayout::snapshotSize) return false;
+
+		uint8_t data[EepromLayout::snapshotSize];
+		const uint8_t size { static_cast<uint8_t>(sizeFor(length)) };
+		uint8_t c { 0 };
+		for (uint8_t i { 0 }; i < size; ++i) {
+			data[i] = read(i);
+			if (i < size - 1) c = Utility::crc8(c, data[i]);
+		}
+		if (c != data[size - 1] || !inside(data[3]) || !inside(data[5]) || data[4] > static_cast<uint8_t>(Direction::NONE) || data[14] >= Levels::count) return false;
+
+		// Pushing the segments again rather than copying the ring means the snake starts
+		//	at the front of its data, which is fine as nothing depends on where it was.
+		SnakeType snake {};
+		PointType p { point(data[3]) };
+		snake.push(p);
+		CrumbPtr body { data + headerSize, 0 };
+		for (uint8_t i { 1 }; i < length; ++i, ++body) {
+			const Direction d { body.getValue() };
+			if (game.detectPlayerOutOfArea(p, d)) return false;
+			p = movePoint(p, d);
+			snake.push(p);
+		}
+		snake.setDirection(static_cast<Direction>(data[4]));
+
+		Random random {};
+		random.state = 0;
+		for (uint8_t i { 0 }; i < 4; ++i) random.state |= static_cast<uint32_t>(data[10 + i]) << (8 * i);
+
+		game.setLevel(data[14]);
+		game.setSnake(snake);
+		game.setScran(point(data[5]));
+		game.setScore(static_cast<uint16_t>(data[6] | (data[7] << 8)));
+		game.setUpdateTime_ms(static_cast<uint16_t>(data[8] | (data[9] << 8)));
+		game.setRandom(random);
+		return true;
+	}
+
+	void discard() { EepromWriter::update(EepromLayout::snapshot, 0xFF); }
+}
+
+#endif // (PAUSE_SNAPSHOT == YES)
@@ -0,0 +1,169 @@
+#include "Sound.hpp"
+#if (SOUND == YES) && (DEBUG == YES)
+#include "CycleCounter.hpp"
+#endif
+
+#if (SOUND == YES)
+
+namespace {
+
+	using namespace Sound;
+
+	static_assert((QueueDepth & (QueueDepth - 1)) == 0, "The queue depth has to be a power of 2.");
+
+	// The tunes.
+	const Note eat[] PROGMEM { note(2000, 10), end };
+	const Note crash[] PROGMEM { note(2000, 20), note(1000, 20), end };
+	const Note gameOver[] PROGMEM {
+		note(2000, 50), rest(450), note(1000, 50),
+		// Rising with the boxes round the text, one a frame.
+		note(200, 3), rest(22), note(400, 3), rest(22), note(600, 3), rest(22), note(800, 3), rest(22),
+		note(1000, 3), rest(22), note(1200, 3), rest(22), note(1400, 3), rest(22), note(1600, 3), rest(22),
+		note(1800, 3), rest(22), note(2000, 3), rest(22), note(2200, 3), rest(22), note(2400, 3), rest(22),
+		note(2600, 3), rest(22), note(2800, 3), rest(22), note(3000, 3), rest(22), note(3200, 3),
+		end
+	};
+	const Note highScore[] PROGMEM { note(1047, 100), note(1319, 100), note(1568, 100), note(2093, 300), end };
+
+	Counters counts {};
+
+#ifdef __AVR__
+	const Note* tuneFor(Effect effect) {
+		switch (effect) {
+			case Effect::Eat: 		return eat;
+			case Effect::Crash: 	return crash;
+			case Effect::GameOver: 	return gameOver;
+			default: 				return highScore;
+		}
+	}
+
+	Priority priorityOf(Effect effect) {
+		switch (effect) {
+			case Effect::Eat: 		return Priority::Low;
+			case Effect::HighScore: return Priority::Top;
+			default: 				return Priority::High;
+		}
+	}
+
+	constexpr uint8_t mask { QueueDepth - 1 };
+
+	// play() adds at tail and the interrupt takes from head, as in EepromWriter.
+	const Note* volatile queue[QueueDepth];
+	volatile uint8_t head { 0 };
+	volatile uint8_t tail { 0 };
+
+	const Note* volatile next { nullptr };		// The next note of the tune playing.
+	volatile uint16_t left { 0 };				// Compare matches left in the note playing.
+	volatile bool resting { false };
+	volatile Priority current { Priority::Low };
+
+	// Writing the pin's bit to its PIN register toggles it.
+	volatile uint8_t* toggle { nullptr };
+	uint8_t bit { 0 };
+
+	bool running() { return (TIMSK2 & _BV(OCIE2A)) != 0; }
+
+	void stop() {
+		TIMSK2 &= ~_BV(OCIE2A);
+		TCCR2B = 0;
+		next = nullptr;
+		digitalWrite(Pin::BUZZER, LOW);
+	}
+
+	// From the interrupt, or with interrupts off.  Set Timer2 for the next note, taking
+	//	the next tune from the queue when the one playing ends.
+	void startNextNote() {
+		while (true) {
+			if (next != nullptr) {
+				const uint8_t clock { pgm_read_byte(&next->clock) };
+				const uint16_t count { pgm_read_word(&next->count) };
+				if (count != 0) {
+					TCCR2B = clock & 0x07;
+					OCR2A = pgm_read_byte(&next->top);
+					TCNT2 = 0;
+					left = count;
+					resting = (clock & Rest) != 0;
+					next = next + 1;
+					return;
+				}
+			}
+			if (head == tail) { stop(); return; }
+			next = queue[head & mask];
+			head = head + 1;
+		}
+	}
+#endif
+}
+
+
+#ifdef __AVR__
+// The end of half a period of the note, or of a ms of a rest.
+ISR(TIMER2_COMPA_vect) {
+#if (DEBUG == YES)
+	const CycleCounter timer {};
+#endif
+	if (!resting) *toggle = bit;
+	left = left - 1;
+	if (left == 0) startNextNote();
+#if (DEBUG == YES)
+	const uint16_t cycles { timer.cycles() };
+	++counts.interrupts;
+	counts.cycles += cycles;
+	if (cycles > counts.worstCycles) counts.worstCycles = cycles;
+#endif
+}
+#endif
+
+
+namespace Sound {
+
+#ifdef __AVR__
+	void begin() {
+		pinMode(Pin::BUZZER, OUTPUT);
+		digitalWrite(Pin::BUZZER, LOW);
+		toggle = portInputRegister(digitalPinToPort(Pin::BUZZER));
+		bit = digitalPinToBitMask(Pin::BUZZER);
+	}
+
+	void play(Effect effect) {
+
+		const Priority priority { priorityOf(effect) };
+		const Utility::InterruptsOff off {};
+
+		if (running()) {
+			if (priority < current) { ++counts.dropped; return; }
+			if (priority > current) {
+				head = tail;
+				next = nullptr;
+				left = 1;		// Ends at the next compare match.
+			}
+		}
+		if (static_cast<uint8_t>(tail - head) == QueueDepth) { ++counts.dropped; return; }
+
+		queue[tail & mask] = tuneFor(effect);
+		tail = tail + 1;
+		current = priority;
+		if (!running()) {
+			TCCR2A = _BV(WGM21);		// Clear the count on OCR2A.
+			startNextNote();
+			TIFR2 = _BV(OCF2A);
+			TIMSK2 |= _BV(OCIE2A);
+		}
+	}
+
+	bool playing() { return running(); }
+
+	Counters counters() {
+		const Utility::InterruptsOff off {};
+		return counts;
+	}
+#else
+	// No Timer2 on the host so nothing is played.
+	void begin() {}
+	void play(Effect) {}
+	bool playing() { return false; }
+	Counters counters() { return counts; }
+#endif
+}
+
+#endif // (SOUND == YES)
@@ -0,0 +1,59 @@
+#include "globals.hpp"
+
+#if (TRACE == YES)
+
+namespace {
+
+	using namespace Trace;
+
+	static_assert((Depth & (Depth - 1)) == 0 && Depth <= 128, "The trace depth has to be a power of 2 up to 128.");
+	static_assert(sizeof(Record) == recordSize, "A trace record is 4 bytes.");
+
+	constexpr uint8_t prefixSize { 7 };		// "TRACE " and the new line.
+
+	void sendByte(uint8_t b) {
+		if (b < 0x10) Serial.print('0');
+		Serial.print(b, HEX);
+	}
+
+	void send(Id id, uint8_t t, uint16_t value) {
+		sendByte(static_cast<uint8_t>(id));
+		sendByte(t);
+		sendByte(static_cast<uint8_t>(value));
+		sendByte(static_cast<uint8_t>(value >> 8));
+	}
+}
+
+
+namespace Trace {
+
+	Record records[Depth] {};
+	uint8_t head { 0 }, tail { 0 };
+	uint16_t tick { 0 }, lost { 0 };
+
+	void drain() {
+
+		const uint8_t waiting { static_cast<uint8_t>(tail - head + (lost != 0)) };
+		if (waiting == 0) return;
+
+		const int room { Serial.availableForWrite() };
+		if (room < prefixSize + 2 * recordSize) return;
+		uint8_t n { static_cast<uint8_t>((room - prefixSize) / (2 * recordSize)) };
+		if (n > lineRecords) n = lineRecords;
+		if (n > waiting) n = waiting;
+
+		Serial.print(F("TRACE "));
+		for (; n > 0 && head != tail; --n, ++head) {
+			const Record& r { records[head & (Depth - 1)] };
+			send(r.id, r.tick, r.value);
+		}
+		// Once what was kept has gone, so the ticks stay in order.
+		if (n > 0 && lost != 0) {
+			send(Id::Lost, static_cast<uint8_t>(tick), lost);
+			lost = 0;
+		}
+		Serial.println();
+	}
+}
+
+#endif // (TRACE == YES)
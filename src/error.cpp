@@ -1,31 +1,111 @@
-
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
 #include "error.hpp"
 
-namespace Error {
+#if (LIVE_ERRORS == YES)
+
+namespace {
+
+	using namespace Error;
+
+	Adafruit_SSD1306* displayPtr = nullptr;
+
+	// The ring.  latest is the newest entry and size how many there are.
+	Entry entries[Depth] {};
+	uint8_t latest { Depth - 1 };
+	uint8_t size { 0 };
+	uint16_t reported { 0 };
+	uint16_t tick { 0 };
 
-Adafruit_SSD1306* displayPtr = nullptr;
+	bool unseen { false };				// An error not yet in a banner.
+	bool showing { false };
+	unsigned long bannerAt_ms { 0 };	// When the last banner went up.
 
-void initErrors(Adafruit_SSD1306& display) {
-	displayPtr = &display;
+	uint8_t sending { 0 };				// Lines of a query answer left to send.
+
+	constexpr uint8_t bannerHeight { 9 };
+	constexpr uint8_t lineSize { 40 };	// The longest line of an answer.
+
+	template <typename Out>
+	void describe(Out& out, const Entry& e) {
+		out.print(F("E")); out.print(static_cast<uint8_t>(e.code));
+		out.print(F(" F")); out.print(e.file);
+		out.print(F(" L")); out.print(e.line);
+	}
 }
 
-void displayError(int16_t line, const char* file, const char* msg) {
-
-	if (displayPtr == nullptr) return;
-	
-	auto& d = *displayPtr;
-
-	d.clearDisplay();
-	d.setTextColor(WHITE);
-	d.setCursor(0, 0);
-	d.setTextSize(1);
-	d.println("ERROR");
-	d.println("Line: ");
-	d.println(line);
-	d.println("File: ");
-	d.println(file);
-	d.println(msg);
-	d.display();
-	delay(10000);
+
+namespace Error {
+
+	void initErrors(Adafruit_SSD1306& display) { displayPtr = &display; }
+
+	void nextTick() { ++tick; }
+
+	void report(Code code, uint8_t file, uint16_t line) {
+
+		++reported;
+		Entry& last { entries[latest] };
+		if (size != 0 && last.code == code && last.file == file && last.line == line) {
+			if (last.count != 0xFF) ++last.count;
+			return;
+		}
+		latest = static_cast<uint8_t>((latest + 1) % Depth);
+		entries[latest] = { code, file, line, tick, 1 };
+		if (size < Depth) ++size;
+		unseen = true;
+	}
+
+	bool update() {
+
+		if (displayPtr == nullptr) return false;
+		auto& d { *displayPtr };
+		const unsigned long now { millis() };
+
+		if (showing) {
+			if (now - bannerAt_ms < bannerShow_ms) return false;
+			showing = false;
+			d.fillRect(0, 0, d.width(), bannerHeight, BLACK);
+			return true;
+		}
+		if (!unseen || (bannerAt_ms != 0 && now - bannerAt_ms < bannerEvery_ms)) return false;
+
+		unseen = false;
+		showing = true;
+		bannerAt_ms = now;
+		d.fillRect(0, 0, d.width(), bannerHeight, WHITE);
+		d.setTextSize(1);
+		d.setTextColor(BLACK);
+		d.setCursor(2, 1);
+		d.print(F("ERROR "));
+		describe(d, entries[latest]);
+		d.setTextColor(WHITE);
+		d.display();
+		return false;
+	}
+
+	void command(char c) {
+		if (c == 'C' || c == 'c') { size = 0; reported = 0; unseen = false; sending = 0; }
+		else if (c == 'E' || c == 'e') sending = static_cast<uint8_t>(size + 1);
+	}
+
+	void poll() {
+
+		if (sending == 0 || Serial.availableForWrite() < lineSize) return;
+
+		// The header line and then the entries, oldest first.
+		if (sending == size + 1) {
+			Serial.print(F("ERRORS ")); Serial.print(size);
+			Serial.print(F(" of ")); Serial.println(reported);
+		} else {
+			const Entry& e { entries[(latest + Depth + 1 - sending) % Depth] };
+			describe(Serial, e);
+			Serial.print(F(" T")); Serial.print(e.tick);
+			Serial.print(F(" x")); Serial.println(e.count);
+		}
+		--sending;
+	}
+
+	uint16_t total() { return reported; }
 }
-}
\ No newline at end of file
+
+#endif // (LIVE_ERRORS == YES)
@@ -1,6 +1,20 @@
 #include "globals.hpp"
 
 
+#if (LARGE_BOARD == YES)
+namespace World {
+
+	Rect World { ScreenWorld };
+
+	bool resize(POINT_DATA_TYPE height, POINT_DATA_TYPE width) {
+		if (static_cast<uint32_t>(height) * width > LARGE_BOARD_MAX_CELLS) return false;
+		World = { 0, 0, height, width };
+		return true;
+	}
+}
+#endif // (LARGE_BOARD == YES)
+
+
 Direction operator~(const Direction direction) {
 	// Return inverted if in range 0-3;
 	if (static_cast<uint8_t>(direction) > 0x03) return static_cast<Direction>(0x4);
@@ -19,19 +19,43 @@
 
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
-#include <EEPROM.h>			// To save hi-score.
 // Timer Interrupt for button debounce.
 #define USE_TIMER_1 true
 #include "TimerInterrupt.h"
 #include "globals.hpp"
 #include "Snake.hpp"
+#include "GameCore.hpp"
+#include "Levels.hpp"
+#include "Replay.hpp"
+#include "EepromLayout.hpp"
+#include "HighScores.hpp"
+#include "EepromWriter.hpp"
+#if (AUTOPILOT == YES) || (ATTRACT_MODE == YES)
+#include "Autopilot.hpp"
+#endif
+#include "DirtyPages.hpp"
+#include "Sound.hpp"
+#if (ATTRACT_MODE == YES) && (DEBUG == YES)
+#include "CycleCounter.hpp"
+#endif
+#if (PAUSE_SNAPSHOT == YES)
+#include "Snapshot.hpp"
+#endif
 #include "error.hpp"
+#include "Profile.hpp"
+#include "memory.hpp"
 
 
-using SnakeType = Snake<SNAKE_DATA_SIZE, PointType>;
+// The game itself.  The snake, the scran, the score and the speed.
+GameCore game {};
 
-// This is our snake.
-SnakeType snake {};
+#if (RECORD_REPLAY == YES)
+// A recording of the current game.
+Replay::Recorder<REPLAY_DATA_SIZE> replay {};
+#if (REPLAY_TO_EEPROM == YES)
+static_assert(REPLAY_DATA_SIZE <= EepromLayout::replaySize, "The replay will not fit in the EEPROM.");
+#endif
+#endif // (RECORD_REPLAY == YES)
 
 // Pressing a button sets this variable.  It is volatile as it is updated from user input.
 volatile Direction lastDirectionPressed { Direction::NONE };
@@ -40,35 +64,28 @@ volatile Direction lastDirectionPressed { Direction::NONE };
 namespace Display {
 	// Initialize the display.
 	Adafruit_SSD1306 display( dspRect.width(), dspRect.height() );  
+
+	// The columns to send for the partial updates of the splash demo and the pause box.
+	//	They are never on at once so they share it.
+	DirtyPages dirty {};
 }
 
 
 // The gameworld space.
 namespace World {
-	
-	// Where the food is.
-	PointType scranPos {};
-
-	// Get a random point.  This is a C++ lambda function.
-	auto getRandomPoint { []()->PointType {
-
-		return { static_cast<POINT_DATA_TYPE>( random(World.minY(), World.maxY()) ),
-				 static_cast<POINT_DATA_TYPE>( random(World.minX(), World.maxX()) ) }; 
-	}};
 
 	// Converts game coordinates to display coordinates.
-	auto toWorld { [](const PointType& p)->PointType {
-		return {	static_cast<POINT_DATA_TYPE>((p.y * Scale) + yMinOffset),
-					static_cast<POINT_DATA_TYPE>((p.x * Scale) + xMinOffset) };
+	auto toWorld { [](const PointType& p)->ScreenPoint {
+		return {	static_cast<uint8_t>((p.y * Scale) + yMinOffset),
+					static_cast<uint8_t>((p.x * Scale) + xMinOffset) };
 	}};
 }
 
 
 namespace Score {
 
-	uint16_t current { 0 };
-	// Highscore is read from the EEPROM non-volatile memory.
-	uint16_t high 	 { ((EEPROM.read(0) != 255) ? static_cast<uint16_t>(EEPROM.read(0) * 10) : 0) };
+	// The best in the high score table.  Read in setup().
+	uint16_t high 	 { 0 };
 }
 
 
@@ -108,8 +125,7 @@ namespace Buttons {
 // Sets the pace of the game.
 namespace Timing {
 
-	uint16_t gameUpdateTime_ms { 300 };						// This decreases as you score points.
-	constexpr uint16_t gameUpdateTimeOnReset_ms { 300 };	// This is the value it resets to.
+	constexpr uint16_t splashUpdateTime_ms { 300 };			// The splash screen and paused game go at this pace.
 	unsigned long lastGameUpdatedTime { 0 };				// A counter used in the loop.
 }
 
@@ -118,33 +134,58 @@ namespace Game {
 		EntrySplash, Running, Paused, GameOver, Error
 	};
 	volatile State state{ State::EntrySplash }; 
+
+	uint8_t level { 0 };		// Picked on the splash screen with left and right.
 }
 
+// The box over the game while it is paused.
+namespace Pause {
 
+	constexpr uint8_t boxWidth { 76 }, boxHeight { 20 };
+	constexpr uint8_t boxX { (Display::dspRect.width() / 2) - (boxWidth / 2) };
+	// Down to the start of a page so the box is on 3 pages rather than 4.
+	constexpr uint8_t boxY { ((Display::dspRect.height() / 2) - (boxHeight / 2) + 7) / 8 * 8 };
 
-// ---------------------------------------------------
-// -------------- Function Declarations --------------
-// ---------------------------------------------------
-/**
- * @brief Check if food eaten.
- * @return true if yes.
- */
-inline bool detectPlayerAteScran();
+	using Under = SaveUnder<boxX, boxY, boxWidth, boxHeight>;
+	static_assert(Under::Size == 3 * boxWidth, "The pause box should be on 3 pages.");
 
-/**
- * @brief Check if the player left the game area.
- * @param newHead A point describing where the new head will be.
- * @return true if out of area else false.
- */
-bool detectPlayerOutOfArea(const PointType& newHead);
+	// What is under the box.  Here rather than on the stack of doPaused(), the deepest
+	//	the stack goes, so the memory report after each build counts it.
+	Under under {};
+}
+
+#if (ATTRACT_MODE == YES)
+// The game the autopilot plays behind the title on the splash screen.
+namespace Attract {
+
+	constexpr uint16_t updateTime_ms { 100 };				// Time between moves of the demo.
+
+	// A frame is one decision, one step, up to four cells drawn and the pages they are on
+	//	sent, so a press is seen within a few ms.  The autopilot looks at the same few
+	//	cells whatever the length so its decision has a fixed cost, and it takes the
+	//	best safe move found so far once this is spent.  Debug builds count decisions
+	//	that still went over.
+	constexpr uint16_t decisionBudget_cycles { 2000 };
+
+	// The title box.  Cells under any of it are not drawn so the snake goes behind it.
+	constexpr uint8_t titleX { 19 }, titleY { 20 }, titleWidth { 90 }, titleHeight { 32 };
+
+	enum class Look : uint8_t { Empty, Body, Head, Scran };
+
+#if (DEBUG == YES)
+	constexpr uint8_t reportEvery { 32 };					// Frames between reports over serial.
+	uint8_t frames { 0 };
+	unsigned long busy_us { 0 };
+	uint16_t overBudget { 0 };
+#endif
+}
+#endif // (ATTRACT_MODE == YES)
 
-/**
- * @brief Check if the player collided with himself.
- * @param newHead A point describing where the new head will be.
- * @return true if a collision is deteced else false.
- */
-bool detectSelfCollision(const PointType& newHead);
 
+
+// ---------------------------------------------------
+// -------------- Function Declarations --------------
+// ---------------------------------------------------
 /**
  * @brief Run the game over sequence.
  */
@@ -177,11 +218,6 @@ void drawSnake(bool wholeSnake = false);
  */
 void redrawAll();
 
-/**
- * @brief Place food at a random location and draw.
- */
-inline void placeRandomScran();
-
 /**
  * @brief Read and debounce a button.
  * @param Button Pointer to the button to be read.
@@ -199,10 +235,16 @@ void readButtons();
 void resetGameParameters();
 
 /**
- * @brief The game loop.
+ * @brief The game loop.  Steps the game and draws and plays what happened.
  */
 void updateGame();
 
+/**
+ * @brief Step the game and draw and play what happened, unless it is over.
+ * @return false if the game is over.
+ */
+bool playTick();
+
 /**
  * @brief Draws the updated score.
  */
@@ -213,6 +255,30 @@ void drawUpdatedScore();
  */
 void doSplashScreen();
 
+/**
+ * @brief Draw the title box and its text on the splash screen.
+ */
+void drawSplashTitle();
+
+#if (ATTRACT_MODE == YES)
+/**
+ * @brief Start a new demo game on the splash screen and draw all of it.
+ */
+void startDemo();
+
+/**
+ * @brief Move the demo game on one step and send the cells that changed.
+ */
+void updateDemo();
+
+/**
+ * @brief Draw a cell of the demo game unless it is under the title and mark it to be sent.
+ * @param p The cell.
+ * @param look What is in it.
+ */
+void drawDemoCell(const PointType& p, Attract::Look look);
+#endif
+
 /**
  * @brief Display a paused message and pause.
  */
@@ -285,7 +351,7 @@ const __FlashStringHelper* stateAsString(Game::State s);
 void setup() {
 
 	using namespace Display;
-	delay(Timing::gameUpdateTime_ms);
+	delay(Timing::splashUpdateTime_ms);
 
 // Initialize interrupt timer for reading the buttons.
 	ITimer1.init();
@@ -297,17 +363,19 @@ void setup() {
 // Initialize the display.
 	display.begin(SSD1306_SWITCHCAPVCC, Address);
 
-#if (DEBUG == YES)
+#if (DEBUG == YES) || (LIVE_ERRORS == YES) || (PROFILE == YES)
 	Serial.begin(9600);
-#endif // (DEBUG == YES)
+#endif // (DEBUG == YES) || (LIVE_ERRORS == YES) || (PROFILE == YES)
 #if (LIVE_ERRORS == YES) // Allows Errors to be displayed on screen.
 	Error::initErrors(display);
 #endif // (LIVE_ERRORS == YES)
+	HighScores::load();
 #if (CLEAR_HIGH_SCORE == YES)
-	EEPROM.update(0, 0);
+	HighScores::clear();
 #endif // (CLEAR_HIGH_SCORE == YES)
+	Score::high = HighScores::best();
 
-    delay(Timing::gameUpdateTime_ms);
+    delay(Timing::splashUpdateTime_ms);
 	// DEBUG_PRINT_FLASH("Size: ("); DEBUG_PRINT(World::maxX);
 	// DEBUG_PRINT_FLASH(", "); DEBUG_PRINT(World::maxY);
 	// DEBUG_PRINTLN_FLASH(")");
@@ -322,6 +390,7 @@ void setup() {
 	for (const auto* button : Buttons::All) {
 		pinMode(button->pin, INPUT_PULLUP);
 	}
+	Sound::begin();
     
 	DEBUG_PRINTLN_FLASH("Setup Complete");
 	DEBUG_PRINT_FLASH("GCC Version: ");
@@ -329,33 +398,70 @@ void setup() {
 	DEBUG_PRINT_FLASH("C++ Version: ");
 	DEBUG_PRINTLN(__cplusplus);
 
-    doSplashScreen();    		// display the snake start up screen
-}
-
+#if (PAUSE_SNAPSHOT == YES)
+	// Carry on, still paused, with a game that was paused when the power went off.
 #if (DEBUG == YES)
-static uint16_t counter{};
+	const auto restoreStart { micros() };
 #endif
+	if (Snapshot::restore(game)) {
+		DEBUG_PRINT_FLASH("Snapshot restored us: "); DEBUG_PRINTLN(micros() - restoreStart);
+		redrawAll();
+		lastDirectionPressed = Direction::NONE;
+		Game::state = Game::State::Paused;
+		return;
+	}
+#endif // (PAUSE_SNAPSHOT == YES)
+
+    doSplashScreen();    		// display the snake start up screen
+}
 
 // Main Loop called from the Arduino API.
 void loop() {
 
 	auto tNow { millis() };
+	const auto updateTime_ms { (Game::state == Game::State::Running) ? game.updateTime_ms() : Timing::splashUpdateTime_ms };
 
 	// Game Loop
-	if (tNow - Timing::lastGameUpdatedTime > Timing::gameUpdateTime_ms) {
+	if (tNow - Timing::lastGameUpdatedTime > updateTime_ms) {
 //		DEBUG_PRINTLN_FLASH("SNAKE AT START:"); DEBUG_PRINTLN(snake);
-		DEBUG_PRINT_FLASH("Turn: "); DEBUG_PRINTLN(++counter); 
+#if (TRACE == YES)
+		Trace::nextTick();
+#endif
+		Error::nextTick();
 		if 		(Game::state == Game::State::Running) 	updateGame();
 		else if (Game::state == Game::State::Paused) 	doPaused();
 		else if (Game::state == Game::State::Error) { 
-			Error::displayError(__LINE__, __FILE__, "In Error State");
-			DEBUG_PRINT_FLASH("Error");
+			// Keep the error and start again rather than stopping.
+			REPORT_ERROR(ErrorState);
+			doSplashScreen();
 		}
 
 //		DEBUG_PRINTLN_FLASH("SNAKE AT END:"); DEBUG_PRINTLN(snake); 
 		Timing::lastGameUpdatedTime = tNow;
-		DEBUG_PRINTLN();
 	}
+#if (TRACE == YES)
+	else Trace::drain();		// Between ticks.
+#endif
+
+	// The score line goes back once an error banner has been shown over it.  The splash
+	//	and game over screens have no score line so the banner waits for a game.
+	const bool scoreLine { Game::state == Game::State::Running || Game::state == Game::State::Paused };
+	if (scoreLine && Error::update()) {
+		Display::display.fillRect(0, 0, Display::dspRect.width(), 9, BLACK);
+		drawDisplayBackground();
+		Display::display.display();
+	}
+
+#if (LIVE_ERRORS == YES) || (PROFILE == YES)
+	// One character commands over serial for whichever of them answers it.
+	if (Serial.available() > 0) {
+		const char c { static_cast<char>(Serial.read()) };
+		Error::command(c);
+		Profile::command(c);
+	}
+#endif
+	Error::poll();
+	Profile::poll();
 }
 
 
@@ -395,6 +501,9 @@ void readButton(Button const* button) {
 // This is called by the timer interrupt.
 void readButtons() {
 
+	Profile::timerTick();
+	PROFILE_ZONE(ReadButtons);
+
 	using namespace Timing;
 	using namespace Game;
 
@@ -426,13 +535,20 @@ void readButtons() {
 void resetGameParameters() {
 
 	lastDirectionPressed = Direction::NONE;
-	snake = SnakeType { }; 					// Create a new empty snake.
-	snake.push( World::getRandomPoint() ); 	// Put the snake in a random place.
-
-	Score::current = 0;						// Reset the score.
-	Timing::gameUpdateTime_ms = Timing::gameUpdateTimeOnReset_ms; // Reset game speed.
+	const auto seed { static_cast<uint32_t>(random(0x7FFFFFFFL)) };
+#if (AUTOPILOT == YES)
+	const uint8_t level { Autopilot::enabled ? uint8_t { 0 } : Game::level };	// The autopilot's cycle needs the open world.
+#else
+	const uint8_t level { Game::level };
+#endif
+	game.reset(seed, level);				// New snake, score, speed and food.
+#if (PAUSE_SNAPSHOT == YES)
+	Snapshot::discard();					// A paused game left for a new one is gone.
+#endif
 
-	placeRandomScran();						// Place the food.
+#if (RECORD_REPLAY == YES)
+	replay.start(seed, game.level());
+#endif
 }
 
 
@@ -447,7 +563,7 @@ void drawDisplayBackground() {
 	// draw scores
 	display.setCursor(2, 1);
 	display.print(F("Score:"));
-	display.print(Score::current);
+	display.print(game.score());
 	
 	display.setCursor((dspRect.width() / 2) + 2, 1);	
 	display.print(F("High:"));
@@ -464,78 +580,77 @@ void drawDisplayBackground() {
 	display.fillRect(0, dspRect.height() - 3, dspRect.width() - 1, 3, WHITE);	// bottom border
 	display.fillRect(0, 9, 3, dspRect.height() - 1, WHITE); 					// left border
 	display.fillRect(dspRect.width() - 3, 9, 3, dspRect.height() - 1, WHITE); 	// right border    
+
+	// The level's walls.  They never change so they are only drawn here.
+	if (game.level() != 0) {
+		using namespace World;
+		const uint8_t* walls { Levels::walls(game.level()) };
+		for (uint8_t y { 0 }; y < ScreenWorld.height(); ++y) {
+			for (uint8_t x { 0 }; x < ScreenWorld.width(); ++x) {
+				const PointType p { static_cast<POINT_DATA_TYPE>(y), static_cast<POINT_DATA_TYPE>(x) };
+				if (!Levels::wall(walls, p)) continue;
+				const auto pos { toWorld(p) };
+				display.fillRect(pos.x, pos.y, Scale, Scale, WHITE);
+				display.drawRect(pos.x + 1, pos.y + 1, Scale - 2, Scale - 2, BLACK);
+			}
+		}
+	}
 }
 
 
 void updateGame() {
 
-// Current order of events.
-// 1. - If direction is changed then change direction.
-// 2. - If snake moving then determine new head position.
-// 3. - Detect if out of area or self collision.  If not add a new head.
-// 4. - Detect if the player ate scran.
-// 5. - If scran eaten then update the score. else pop the tail and rub out the tail.
-// 6. - Draw the snake.
-// 7. - If scran eaten then replace the scran.
-// 8. - Update the display.
-    
-	using namespace Display;
-	auto scranEaten { false };
+// 1. - Step the game.
+// 2. - If the game is over then do the game over sequence.
+// 3. - If scran eaten then update the score and draw the new scran. else rub out the tail.
+// 4. - Draw the snake.
+// 5. - Update the display.
 
-// Update the Snake's direction from button input if not same or opposite direction.
-	DEBUG_PRINTLN(directionAsString(lastDirectionPressed));
+	// The game over sequence is outside the UpdateGame zone as it waits on the splash
+	//	screen for the next game.
+	if (!playTick()) doGameOver();
+}
 
-	if (lastDirectionPressed != snake.getDirection()) {
-		DEBUG_PRINTLN(directionAsString(~lastDirectionPressed));
-		if (lastDirectionPressed != ~snake.getDirection())
-			snake.setDirection(lastDirectionPressed);
-	}
 
-// Save current head position.
-	const auto currentHead = snake.head();
-
-// If the snake is moving.
-	if (snake.getDirection() != Direction::NONE) { 
-
-		// Move the Snake.
-		PointType newHead {};
-
-		switch (snake.getDirection()) { 
-			case Direction::UP:
-				newHead = {static_cast<POINT_DATA_TYPE>(currentHead.y - 1), currentHead.x };
-				break;
-			case Direction::DOWN:
-				newHead = { static_cast<POINT_DATA_TYPE>(currentHead.y + 1), currentHead.x };
-				break;
-			case Direction::LEFT:
-				newHead = { currentHead.y, static_cast<POINT_DATA_TYPE>(currentHead.x - 1) };
-				break;
-			case Direction::RIGHT:
-				newHead = { currentHead.y, static_cast<POINT_DATA_TYPE>(currentHead.x + 1) };
-				break;
-			default: break;
-		}
-		//DEBUG_PRINTLN((snake.pointIsInside(newHead))?"true":"false");
-		if (detectPlayerOutOfArea(newHead) || detectSelfCollision(newHead)) {	
-			doGameOver();
-			return;
-		} else snake.push(newHead);
+bool playTick() {
 
-		scranEaten = detectPlayerAteScran();
-		
-		if (scranEaten) { // If eating tail stays put and only head advances.
-			drawUpdatedScore();
-		} else {
-			auto removed = snake.pop();
+	PROFILE_ZONE(UpdateGame);
+	using namespace Display;
 
-			// best place to remove the tail.
-			display.fillRect((removed.x * World::Scale) + World::xMinOffset, (removed.y * World::Scale) + World::yMinOffset, World::Scale, World::Scale, BLACK);
-		}
+#if (AUTOPILOT == YES)
+	const Direction input { Autopilot::enabled ? Autopilot::nextDirection(game) : lastDirectionPressed };
+	if (Autopilot::enabled) { TRACE_EVENT(Autopilot, Autopilot::lastCycles()); }
+#else
+	const Direction input { lastDirectionPressed };
+#endif
+	TRACE_EVENT(Input, static_cast<uint8_t>(input));
+	const auto events { game.step(input) };
+
+#if (RECORD_REPLAY == YES)
+	replay.record(game);
+#endif
+
+	if (events.gameOver()) {
+		if (events.has(GameEvents::HitSelf)) Sound::play(Sound::Effect::Crash);
+		return false;
 	}
-	//DEBUG_PRINTLN_FLASH("Draw");
+
+	if (events.has(GameEvents::Ate)) {
+		Sound::play(Sound::Effect::Eat);
+		drawUpdatedScore();
+		drawScran();
+	} else if (events.has(GameEvents::Moved)) {
+		// best place to remove the tail.
+		const auto& removed { events.removedTail };
+		display.fillRect((removed.x * World::Scale) + World::xMinOffset, (removed.y * World::Scale) + World::yMinOffset, World::Scale, World::Scale, BLACK);
+	}
+
 	drawSnake();
-	if (scranEaten) { placeRandomScran(); }
-	display.display();
+	{
+		PROFILE_ZONE(Display);
+		display.display();
+	}
+	return true;
 }
 
 
@@ -544,34 +659,62 @@ void doSplashScreen() {
 	using namespace Display;
 	Game::state = Game::State::EntrySplash;
 	clear();
+#if (AUTOPILOT == YES)
+	const auto splashStart { millis() };
+#endif
+#if (ATTRACT_MODE == YES)
+	startDemo();
+#endif
 
 	while (Game::state == Game::State::EntrySplash) {
 
 		auto tNow { millis() };
 
-		if (tNow - Timing::lastGameUpdatedTime > Timing::gameUpdateTime_ms) {
+#if (ATTRACT_MODE == YES)
+		if (tNow - Timing::lastGameUpdatedTime > Attract::updateTime_ms && lastDirectionPressed == Direction::NONE) {
+			updateDemo();
+			Timing::lastGameUpdatedTime = tNow;
+		}
+#else
+		if (tNow - Timing::lastGameUpdatedTime > Timing::splashUpdateTime_ms) {
 
 			drawARandomLine(); // draw a random white line
 			drawARandomLine(BLACK); // draw a random black line so that the screen not completely fill white
-
-			display.fillRect(19, 20, 90, 32, BLACK); // blank background for text
-			display.setTextColor(WHITE);
-			display.setCursor(35, 25);
-			display.setTextSize(2); // bigger font
-			display.println(F("SNAKE"));
-							//    x  y   w  h r  col
-			display.drawRoundRect(33, 22, 62, 20, 4,WHITE);  // border Snake
-			display.drawRect(19, 20, 90, 32, WHITE);         // border box  - 3
-			display.setCursor(28, 42);
-			display.setTextSize(0);  // font back to normal
-
-			display.println(F("press any key"));
+			drawSplashTitle();
 			display.display();
 			
 			Timing::lastGameUpdatedTime = tNow;
 		}
+#endif
+
+#if (TRACE == YES)
+		Trace::drain();
+#endif
+
+#if (AUTOPILOT == YES)
+		// After an autopilot game the next one starts by itself.
+		if (Autopilot::enabled && millis() - splashStart > Autopilot::restartDelay_ms) lastDirectionPressed = Direction::MIDDLE;
+#endif
+
+		// Left and right pick the level.
+		if (Levels::count > 1 && (lastDirectionPressed == Direction::LEFT || lastDirectionPressed == Direction::RIGHT)) {
+			const uint8_t by { static_cast<uint8_t>((lastDirectionPressed == Direction::LEFT) ? Levels::count - 1 : 1) };
+			Game::level = static_cast<uint8_t>((Game::level + by) % Levels::count);
+			lastDirectionPressed = Direction::NONE;
+			drawSplashTitle();
+#if (ATTRACT_MODE == YES)
+			Display::dirty.mark(Attract::titleX, Attract::titleY, Attract::titleWidth, Attract::titleHeight);
+			Display::dirty.flush(display);
+#else
+			display.display();
+#endif
+		}
 
 		if (lastDirectionPressed != Direction::NONE) {
+#if (AUTOPILOT == YES)
+			// The middle button starts an autopilot game.  The others a normal one.
+			Autopilot::enabled = (lastDirectionPressed == Direction::MIDDLE);
+#endif
 			lastDirectionPressed = Direction::NONE;
 				//DEBUG_PRINTLN_FLASH("Resetting Game Parameters.");
 			resetGameParameters();
@@ -582,12 +725,122 @@ void doSplashScreen() {
 }
 
 
+void drawSplashTitle() {
+
+	using namespace Display;
+	display.fillRect(19, 20, 90, 32, BLACK); // blank background for text
+	display.setTextColor(WHITE);
+	display.setCursor(35, 25);
+	display.setTextSize(2); // bigger font
+	display.println(F("SNAKE"));
+					//    x  y   w  h r  col
+	display.drawRoundRect(33, 22, 62, 20, 4,WHITE);  // border Snake
+	display.drawRect(19, 20, 90, 32, WHITE);         // border box  - 3
+	display.setCursor(28, 42);
+	display.setTextSize(0);  // font back to normal
+
+	if (Levels::count > 1) {
+		// "< name >" in the middle of the box.  Names are up to 9 characters.
+		const uint8_t length { static_cast<uint8_t>(strlen_P(reinterpret_cast<const char*>(Levels::name(Game::level))) + 4) };
+		display.setCursor(19 + (90 - length * 6) / 2, 42);
+		display.print(F("< "));
+		display.print(Levels::name(Game::level));
+		display.print(F(" >"));
+	} else display.println(F("press any key"));
+}
+
+
+#if (ATTRACT_MODE == YES)
+void startDemo() {
+
+	using namespace Display;
+	game.reset(static_cast<uint32_t>(random(0x7FFFFFFFL)));
+
+	clear();
+	drawSplashTitle();
+	drawDemoCell(game.scran(), Attract::Look::Scran);
+	drawDemoCell(game.snake().head(), Attract::Look::Head);
+	Display::dirty.markAll();
+	Display::dirty.flush(display);
+}
+
+
+void updateDemo() {
+
+	PROFILE_ZONE(Demo);
+	using Attract::Look;
+#if (DEBUG == YES)
+	const auto start { micros() };
+#endif
+
+#if (DEBUG == YES)
+	const CycleCounter timer {};
+#endif
+	const Direction d { Autopilot::decide(game, Attract::decisionBudget_cycles) };
+#if (DEBUG == YES)
+	if (timer.cycles() > Attract::decisionBudget_cycles) ++Attract::overBudget;
+#endif
+
+	const PointType oldHead { game.snake().head() };
+	const auto events { game.step(d) };
+
+	// The autopilot does not crash so this is a full board.  Start again.
+	if (events.gameOver()) {
+		startDemo();
+		return;
+	}
+
+	if (events.has(GameEvents::Moved)) {
+		drawDemoCell(oldHead, Look::Body);
+		if (events.has(GameEvents::Ate)) drawDemoCell(game.scran(), Look::Scran);
+		else drawDemoCell(events.removedTail, Look::Empty);
+		drawDemoCell(events.head, Look::Head);
+	}
+	Display::dirty.flush(Display::display);
+
+#if (DEBUG == YES)
+	// The CPU time and the I2C bytes a second of the splash screen.  Random lines
+	//	were about DirtyPages::fullScreenBytes every Timing::splashUpdateTime_ms.
+	Attract::busy_us += micros() - start;
+	if (++Attract::frames == Attract::reportEvery) {
+		DEBUG_PRINT_FLASH("Splash us a frame: "); DEBUG_PRINT(Attract::busy_us / Attract::reportEvery);
+		DEBUG_PRINT_FLASH(" I2C bytes a second: "); DEBUG_PRINT(Display::dirty.takeBytes() * 1000UL / (Attract::reportEvery * Attract::updateTime_ms));
+		DEBUG_PRINT_FLASH(" decisions over budget: "); DEBUG_PRINTLN(Attract::overBudget);
+		Attract::frames = 0;
+		Attract::busy_us = 0;
+	}
+#endif
+}
+
+
+void drawDemoCell(const PointType& p, Attract::Look look) {
+
+	using namespace Attract;
+	using namespace World;
+	auto& d = Display::display;
+	const auto pos { toWorld(p) };
+
+	if (pos.x + Scale > titleX && pos.x < titleX + titleWidth &&
+		pos.y + Scale > titleY && pos.y < titleY + titleHeight) return;
+
+	d.fillRect(pos.x, pos.y, Scale, Scale, BLACK);
+	switch (look) {
+		case Look::Head: 	d.fillRect(pos.x, pos.y, Scale, Scale, WHITE); break;
+		case Look::Body: 	d.fillRect(pos.x + 1, pos.y + 1, Scale - 1, Scale - 1, WHITE); break;
+		case Look::Scran: 	d.drawRect(pos.x, pos.y, Scale, Scale, WHITE); break;
+		default: 			break;
+	}
+	Display::dirty.mark(pos.x, pos.y, Scale, Scale);
+}
+#endif // (ATTRACT_MODE == YES)
+
+
 void drawARandomLine(uint8_t colour) {
 
 	auto getRand { [](uint8_t max) -> uint8_t { return static_cast<uint8_t>(random(0, max)); } };
 
-	PointType start { getRand(Display::dspRect.maxY()), getRand(Display::dspRect.maxX()) };
-	PointType end   { getRand(Display::dspRect.maxY()), getRand(Display::dspRect.maxX()) };
+	ScreenPoint start { getRand(Display::dspRect.maxY()), getRand(Display::dspRect.maxX()) };
+	ScreenPoint end   { getRand(Display::dspRect.maxY()), getRand(Display::dspRect.maxX()) };
 	
 	Display::display.drawLine(start.x, start.y, end.x, end.y, colour);
 }
@@ -597,6 +850,7 @@ void drawScran() {
 
 	auto& d = Display::display;
 	using namespace World;
+	const auto& scranPos { game.scran() };
 	d.drawRect ( ( scranPos.x * Scale ) + xMinOffset,
 				 ( scranPos.y * Scale ) + yMinOffset,
 				   Scale,
@@ -614,8 +868,10 @@ void drawScran() {
 
 void drawSnake(bool wholeSnake) {
 
+	PROFILE_ZONE(DrawSnake);
 	using namespace World;
 	using namespace Display;
+	const auto& snake { game.snake() };
 
 	auto headPos = toWorld(snake.head());
 
@@ -658,20 +914,7 @@ void drawUpdatedScore() {
 	// draw scores
 	display.fillRect(36, 1, 27, 8, BLACK);
 	display.setCursor(38, 1);
-	display.print(Score::current);
-}
-
-
-void placeRandomScran() {
-
-	using namespace World;
-	do {
-		scranPos = getRandomPoint();
-		DEBUG_PRINT_FLASH("scranpos: "); DEBUG_PRINTLN(scranPos);
-	} while (snake.pointIsInside(scranPos));
-
-	// Draw scran here cause only want to draw one time.
-	drawScran();
+	display.print(game.score());
 }
 
 
@@ -686,98 +929,47 @@ void redrawAll() {
 }
 
 
-//#pragma message "detect ate scran and related game updates should be separate."
-bool detectPlayerAteScran() {
-	if (snake.head() == World::scranPos) {
-
-		//DEBUG_PRINTLN_FLASH("Player ate scran");
-		Score::current += 10;
-
-		if (Score::current % 100 == 0)
-			Timing::gameUpdateTime_ms -= (Timing::gameUpdateTime_ms / 10);            
-		
-		tone(Pin::SOUND, 2000, 10);
-		return true;
-	}
-	return false;
-}
-
-
-
-bool detectSelfCollision(const PointType& newHead) {
-
-	auto hasCollided { snake.pointIsInside(newHead) };
-
-	if (hasCollided && hasCollided.getValue() != snake.tail()) {
-
-			tone(Pin::SOUND, 2000, 20);
-			tone(Pin::SOUND, 1000, 20);
-			DEBUG_PRINT_FLASH("Detected self collision at: "); 
-			DEBUG_PRINTLN(hasCollided.getValue());
-			DEBUG_PRINTLN(snake);
-			return true;
-	}
-	return false;
-}
-
-
-
-bool detectPlayerOutOfArea(const PointType& newHead) {
-
-	using World::World;
-
-#if (DEBUG == 1)
-	bool rVal;
-	if constexpr(Utility::is_unsigned<POINT_DATA_TYPE>::value)
-		rVal = (( newHead.x >= World.maxX()  ) || ( newHead.y >= World.maxY() ));
-	else 
-		rVal = (( newHead.x >= World.maxX() ) || ( newHead.x < 0 ) || 
-				( newHead.y >= World.maxY() ) || ( newHead.y < 0 ));
-	
-	if (rVal) {
-
-		//DEBUG_PRINT_FLASH("head pos: ");
-		//PointType newHeadScaled { static_cast<uint8_t>(newHead.y / World::Scale), static_cast<uint8_t>(newHead.x / World::Scale) };
-		//DEBUG_PRINTLN(newHeadScaled);
-		//DEBUG_PRINT_FLASH("World min/max: ");
-		//PointType WorldMin { World.minY(), World.minX() };
-		//DEBUG_PRINT(WorldMin);
-		//PointType WorldMax { World.maxY(), World.maxX() };
-		//DEBUG_PRINT_FLASH(", ");
-		//DEBUG_PRINTLN( WorldMax );
-		DEBUG_PRINTLN_FLASH("Detected out of area");
-	}
-	return rVal;
-#else
-	if constexpr(Utility::is_unsigned<POINT_DATA_TYPE>::value)
-		return (( newHead.y >= World.maxY() ) || ( newHead.x >= World.maxX() ));
-	else return (( newHead.x >= World.maxX() ) || ( newHead.x < 0 ) ||
-				( newHead.y >= World.maxY() || newHead.y < 0 ));
-#endif
-}
-
-
-
 void doGameOver() {
     
 	using namespace Display;
 	using namespace World;
 	Game::state = Game::State::GameOver;
+	const auto& snake { game.snake() };
+	{
+		// The animations after it have zones of their own, a frame each.
+		PROFILE_ZONE(GameOver);
+#if (PAUSE_SNAPSHOT == YES)
+		Snapshot::discard();
+#endif
+
+#if (RECORD_REPLAY == YES)
+		replay.finish(game);
+#if (DEBUG == YES)
+		replay.printTo(Serial);
+#endif
+#if (REPLAY_TO_EEPROM == YES)
+		replay.save(EepromLayout::replay);
+#endif
+#endif // (RECORD_REPLAY == YES)
+	}
 
 	// Flash the snake
 	bool on { false };
 	uint8_t dly { 60 };
 
 	for (uint8_t i { 0 }; i < 17; ++i) {
-		if (!on) 
-			for (uint16_t i { 0 }; i < snake.length(); ++i) {
-				auto pos = toWorld(snake[i]);
-				display.fillRect(pos.x, pos.y, Scale, Scale, BLACK);
-			}
-		else 
-			drawSnake(true);
+		{
+			PROFILE_ZONE(Flash);
+			if (!on) 
+				for (uint16_t i { 0 }; i < snake.length(); ++i) {
+					auto pos = toWorld(snake[i]);
+					display.fillRect(pos.x, pos.y, Scale, Scale, BLACK);
+				}
+			else 
+				drawSnake(true);
 
-		display.display();
+			display.display();
+		}
 		on = !on;
 		delay(dly);
 		dly -= 4;
@@ -788,16 +980,16 @@ void doGameOver() {
     display.setCursor(40, 30);
     display.setTextSize(1);
     
-	tone(Pin::SOUND, 2000, 50);
+	Sound::play(Sound::Effect::GameOver);		// Goes with the text and the boxes after it.
     display.print(F("GAME OVER"));
     delay(500);
-	tone(Pin::SOUND, 1000, 50);
 //    display.print(F("OVER"));
 
 	uint8_t rectX1 { 38 }, rectY1 { 28 }, rectX2 { 58 }, rectY2 { 12 };
 
     for (uint8_t i = 0; i <= 16; ++i) { // this is to draw rectangles around game over
 
+		PROFILE_ZONE(Boxes);
 		display.drawRect(rectX1, rectY1, rectX2, rectY2, WHITE);
 		display.display();
 
@@ -805,8 +997,6 @@ void doGameOver() {
 		rectY1 -= 2;
 		rectX2 += 4;      // shift over 2 pixels from last point
 		rectY2 += 4;
-
-		tone(Pin::SOUND, i * 200, 3);
 	}
 
 	display.display();          
@@ -818,6 +1008,7 @@ void doGameOver() {
 
 	for (uint8_t i{0}; i <= 64; i++) {
 		
+		PROFILE_ZONE(Wipe);
 		display.drawLine(rectX1, rectY1, rectX2, rectY2, BLACK); 
 		++rectX1;
 		++rectX2;
@@ -828,11 +1019,41 @@ void doGameOver() {
 		display.display();                          
     }
 
-	if (Score::current > Score::high) {
-		Score::high = Score::current;
-		doHighScore();
-		EEPROM.write(0, Score::high / 10);
+#if (AUTOPILOT == YES)
+	DEBUG_PRINT_FLASH("Autopilot worst cycles: "); DEBUG_PRINT(Autopilot::worstCycles());
+	DEBUG_PRINT_FLASH(" of "); DEBUG_PRINTLN(static_cast<uint32_t>(game.updateTime_ms()) * (F_CPU / 1000));
+	const bool autopilotGame { Autopilot::enabled };
+#else
+	constexpr bool autopilotGame { false };
+#endif
+
+	// The autopilot does not get the high score.  The unit plays the screen sized world,
+	//	so the score fits the table's 16 bits even with LARGE_BOARD.
+	if (!autopilotGame) {
+		const uint16_t score { static_cast<uint16_t>(game.score()) };
+		if (score > Score::high) {
+			Score::high = score;
+			doHighScore();
+		}
+		HighScores::add(score);
 	}
+
+#if (DEBUG == YES)
+	Memory::report(Serial);
+	const auto& eeprom { EepromWriter::counters() };
+	DEBUG_PRINT_FLASH("EEPROM bytes queued: "); DEBUG_PRINT(eeprom.queued);
+	DEBUG_PRINT_FLASH(" skipped: "); DEBUG_PRINT(eeprom.skipped);
+	DEBUG_PRINT_FLASH(" deepest: "); DEBUG_PRINT(eeprom.deepest);
+	DEBUG_PRINT_FLASH(" of "); DEBUG_PRINT(EepromWriter::Depth);
+	DEBUG_PRINT_FLASH(" stalled us: "); DEBUG_PRINTLN(eeprom.stall_us);
+#if (SOUND == YES)
+	const auto sound { Sound::counters() };
+	DEBUG_PRINT_FLASH("Sound interrupts: "); DEBUG_PRINT(sound.interrupts);
+	DEBUG_PRINT_FLASH(" cycles: "); DEBUG_PRINT(sound.cycles);
+	DEBUG_PRINT_FLASH(" worst: "); DEBUG_PRINT(sound.worstCycles);
+	DEBUG_PRINT_FLASH(" tunes dropped: "); DEBUG_PRINTLN(sound.dropped);
+#endif // (SOUND == YES)
+#endif // (DEBUG == YES)
     
 	lastDirectionPressed = Direction::NONE;
 	doSplashScreen();		// wait for player to re-start game
@@ -842,37 +1063,62 @@ void doGameOver() {
 void doPaused() {
 
 	using namespace Display;
+	using namespace Pause;
+
+	// Keep what is under the box so that resuming puts it back rather than drawing the
+	//	snake again.
+	under.save(display);
+	dirty.takeBytes();			// Only count the pause's bytes.
 
 	// Draw a box.
-	SizeType boxSize { 20, 76 };
-	display.fillRect((dspRect.width() / 2) - (boxSize.x / 2) , (dspRect.height() / 2) - (boxSize.y / 2), boxSize.x, boxSize.y, BLACK);
-	display.drawRect((dspRect.width() / 2) - (boxSize.x / 2) , (dspRect.height() / 2) - (boxSize.y / 2), boxSize.x, boxSize.y, WHITE);
+	display.fillRect(boxX, boxY, boxWidth, boxHeight, BLACK);
+	display.drawRect(boxX, boxY, boxWidth, boxHeight, WHITE);
 
 	// Write paused.
 	display.setTextSize(2);
-	display.setCursor((dspRect.width() / 2) - (boxSize.x / 2) + 3 , (dspRect.height() / 2) + 3 - (boxSize.y / 2));
+	display.setCursor(boxX + 3, boxY + 3);
 	display.print(F("Paused"));
 
 	// Display
-	display.display();
+	dirty.mark(boxX, boxY, boxWidth, boxHeight);
+	dirty.flush(display);
+
+#if (PAUSE_SNAPSHOT == YES)
+	// After the box is up so it shows at once.  The bytes are written while paused.
+#if (DEBUG == YES)
+	const auto saveStart { micros() };
+	const uint8_t saved { Snapshot::save(game) };
+	DEBUG_PRINT_FLASH("Snapshot bytes: "); DEBUG_PRINT(saved);
+	DEBUG_PRINT_FLASH(" saved us: "); DEBUG_PRINTLN(micros() - saveStart);
+#else
+	Snapshot::save(game);
+#endif
+#endif // (PAUSE_SNAPSHOT == YES)
+#if (DEBUG == YES)
+	Memory::report(Serial);		// The stack is deepest in the save above.
+#endif
 
 	// Wait while paused.
 	while(Game::state == Game::State::Paused) {
 		if (lastDirectionPressed == Direction::MIDDLE) {
 			Game::state = Game::State::Running;
-			lastDirectionPressed = snake.getDirection();
+			lastDirectionPressed = game.direction();
 			break;
 		}
 	}
+#if (PAUSE_SNAPSHOT == YES)
+	Snapshot::discard();		// Only a pause is kept, not a game that has gone on since.
+#endif
 
-	// Redraw everything.
+	// Put back what was under the box.
 	display.setTextSize(1);
-
-	display.fillRect((dspRect.width() / 2) - (boxSize.x / 2) , (dspRect.height() / 2) - (boxSize.y / 2), boxSize.x, boxSize.y, BLACK);
-
-	drawSnake(true);
-	drawScran();
-	display.display();
+#if (DEBUG == YES)
+	const auto resumeStart { micros() };
+#endif
+	under.restore(display, dirty);
+	dirty.flush(display);
+	DEBUG_PRINT_FLASH("Resumed us: "); DEBUG_PRINT(micros() - resumeStart);
+	DEBUG_PRINT_FLASH(" I2C bytes: "); DEBUG_PRINTLN(dirty.takeBytes());
 }
 
 
@@ -901,6 +1147,7 @@ void doHighScore() {
 	
 	clear();
 	display.display();
+	Sound::play(Sound::Effect::HighScore);
 	const auto startTime { millis() };
 
 	while (true) {
@@ -919,6 +1166,7 @@ void doHighScore() {
 
 		for (uint8_t i{0}; rOuter.width() <= dspRect.width(); ++i) {
 
+			PROFILE_ZONE(HighScore);
 			rOuter.centreOn(dspRect);
 			rInner.centreOn(dspRect);
 
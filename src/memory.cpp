@@ -0,0 +1,67 @@
+#include "memory.hpp"
+
+#ifdef __AVR__
+
+// From the linker and avr-libc.
+extern "C" {
+	extern uint8_t _end;		// End of .bss.
+	extern uint8_t __heap_start;
+	extern char* __brkval;		// Top of the heap or 0 if malloc has not been used.
+}
+
+namespace {
+
+	// Runs from .init3, after the stack pointer and zero register are set up but
+	//	before .bss is cleared or any constructors are called.
+	void paintStack() __attribute__((naked, used, section(".init3")));
+	void paintStack() {
+		uint8_t* p { &_end };
+		while (p <= reinterpret_cast<uint8_t*>(SP)) *p++ = Memory::paintByte;
+	}
+
+	const uint8_t* heapTop() {
+		return (__brkval == nullptr) ? &__heap_start : reinterpret_cast<const uint8_t*>(__brkval);
+	}
+}
+
+namespace Memory {
+
+uint16_t stackUnused() {
+	const uint8_t* p { heapTop() };
+	uint16_t count { 0 };
+	while (p <= reinterpret_cast<const uint8_t*>(RAMEND) && *p++ == paintByte) ++count;
+	return count;
+}
+
+uint16_t stackHighWaterMark() {
+	return static_cast<uint16_t>(reinterpret_cast<const uint8_t*>(RAMEND) - heapTop() + 1) - stackUnused();
+}
+
+uint16_t freeRam() {
+	return static_cast<uint16_t>(reinterpret_cast<const uint8_t*>(SP) - heapTop());
+}
+
+}
+
+#else
+
+namespace Memory {
+uint16_t stackUnused() { return 0; }
+uint16_t stackHighWaterMark() { return 0; }
+uint16_t freeRam() { return 0; }
+}
+
+#endif // __AVR__
+
+namespace Memory {
+
+void report(Print& p) {
+	p.print(F("MEM stack_max="));
+	p.print(stackHighWaterMark());
+	p.print(F(" stack_unused="));
+	p.print(stackUnused());
+	p.print(F(" free="));
+	p.println(freeRam());
+}
+
+}
@@ -0,0 +1,635 @@
+// Batch simulator
+// Plays thousands of games at once to tune the difficulty and the AI.  Each game is a
+//	lane of a set of arrays, one array for each part of the state (struct of arrays):
+//	heads, tails, crumb rings, scran, scores and random number states.  A tick moves every
+//	lane together, 8 at a time with AVX2 or 4 with SSE4.1, with masks for the games that
+//	have ended.  When a game ends its lane is given the next one.
+//
+//	The snake in each lane is a crumb ring, as Snake keeps it, and a bitboard of the cells
+//	it is in so that the collision check is one bit test rather than a walk of the snake.
+//	The parts that write to one place in one lane, the crumb of the new head, the bits of
+//	the head and the tail and placing the scran, are done a lane at a time after the
+//	vector step as AVX2 has no scatter.
+//
+//	Every game is also played through GameCore and the results have to match.  The games
+//	per second of GameCore and each kernel are printed.
+//	Built by the batch_sim environment in platformio.ini:
+//		pio run -e batch_sim && .pio/build/batch_sim/program [options]
+//
+//	Options:
+//		--games <n>			Number of games.  10000 by default.
+//		--lanes <n>			Games played at once.  1024 by default.
+//		--seed <n>			Seed of the first game.  The rest count up from it.
+//		--policy <p>		random, cycle or mixed (every other game).  mixed by default.
+//		--max-ticks <n>		Games still going after this many ticks are stopped.
+//		--kernel <k>		plain, sse, avx2 or all.  all by default.
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "globals.hpp"
+#include "GameCore.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCH_X86 1
+#else
+#define BATCH_X86 0
+#endif
+
+static_assert(LARGE_BOARD == NO, "The batch simulator plays the screen sized world.");
+
+
+namespace Batch {
+
+	constexpr int32_t Height { World::World.height() };
+	constexpr int32_t Width { World::World.width() };
+	constexpr int32_t Cells { Height * Width };
+	constexpr int32_t OccupiedWords { (Cells + 31) / 32 };	// 32 cells a word.
+	constexpr int32_t RingSize { Cells };					// Crumbs.  A snake has length - 1.
+	constexpr int32_t CrumbWords { (RingSize + 15) / 16 };	// 16 crumbs a word.
+
+	constexpr int32_t Up { static_cast<int32_t>(Direction::UP) };
+	constexpr int32_t Left { static_cast<int32_t>(Direction::LEFT) };
+	constexpr int32_t Right { static_cast<int32_t>(Direction::RIGHT) };
+	constexpr int32_t Down { static_cast<int32_t>(Direction::DOWN) };
+	constexpr int32_t None { static_cast<int32_t>(Direction::NONE) };
+
+	enum class Policy : uint8_t { Random, Cycle, Mixed };
+
+	enum class Cause : uint8_t { HitWall, HitSelf, Won, TimedOut };
+	constexpr uint8_t Causes { 4 };
+
+	const char* causeName(Cause c) {
+		switch (c) {
+			case Cause::HitWall: 	return "hit the wall";
+			case Cause::HitSelf: 	return "hit itself";
+			case Cause::Won: 		return "filled the board";
+			default: 				return "timed out";
+		}
+	}
+
+	struct Result {
+		uint32_t seed { 0 };
+		uint32_t ticks { 0 };
+		uint16_t score { 0 };
+		uint16_t length { 0 };
+		Cause cause { Cause::TimedOut };
+		uint8_t checksum { 0 };		// GameCore::checksum() at the end.
+
+		bool operator==(const Result& o) const {
+			return seed == o.seed && ticks == o.ticks && score == o.score && length == o.length &&
+				   cause == o.cause && checksum == o.checksum;
+		}
+		bool operator!=(const Result& o) const { return !(*this == o); }
+	};
+
+
+	// *** Policies ***
+	// The directions a game is given only depend on its seed, its tick and where the head
+	//	is so that the lanes and GameCore are given the same ones.
+
+	// A turn about one tick in four, else carry on.  Mostly hits the wall before long.
+	int32_t randomDirection(uint32_t seed, uint32_t tick) {
+		uint32_t h { static_cast<uint32_t>(seed * 0x9E3779B1UL ^ tick * 0x85EBCA6BUL) };
+		h ^= h >> 15; h *= 0x2C1B3C6DUL; h ^= h >> 12;
+		const int32_t v { static_cast<int32_t>(h >> 28) };
+		return (v <= Down) ? v : None;
+	}
+
+	// Round the Hamiltonian cycle so the game goes on until the board is full.
+	//	Row 0 right, odd rows left to column 1 then down, even rows right, column 0 up.
+	int32_t cycleDirection(int32_t y, int32_t x) {
+		static_assert(Height % 2 == 0, "The cycle needs an even number of rows.");
+		if (x == 0) return (y == 0) ? Right : Up;
+		if (y % 2 == 1) {
+			if (x > 1) return Left;
+			return (y == Height - 1) ? Left : Down;
+		}
+		return (x < Width - 1) ? Right : Down;
+	}
+
+	Policy policyOf(Policy p, uint32_t game) {
+		if (p != Policy::Mixed) return p;
+		return (game % 2 == 0) ? Policy::Random : Policy::Cycle;
+	}
+
+	int32_t direction(Policy p, uint32_t seed, uint32_t tick, int32_t y, int32_t x) {
+		return (p == Policy::Cycle) ? cycleDirection(y, x) : randomDirection(seed, tick);
+	}
+
+
+	// *** The scalar path ***
+
+	Result playGameCore(uint32_t seed, Policy policy, uint32_t maxTicks) {
+
+		GameCore game {};
+		game.reset(seed);
+
+		Result r {};
+		r.seed = seed;
+		GameEvents events {};
+		while (r.ticks < maxTicks) {
+			const PointType& head { game.snake().head() };
+			events = game.step(static_cast<Direction>(direction(policy, seed, r.ticks, head.y, head.x)));
+			++r.ticks;
+			if (events.gameOver()) break;
+		}
+
+		if (events.has(GameEvents::HitWall)) r.cause = Cause::HitWall;
+		else if (events.has(GameEvents::HitSelf)) r.cause = Cause::HitSelf;
+		else if (events.has(GameEvents::Won)) r.cause = Cause::Won;
+		r.score = game.score();
+		r.length = static_cast<uint16_t>(game.snake().length());
+		r.checksum = game.checksum();
+		return r;
+	}
+
+
+	// *** The lanes ***
+
+	// Lane i of each array is game i.  Booleans are 0 or -1 so they can be used as masks.
+	//	occupied and crumbs have several words a lane, word w of lane i at w * count + i, so
+	//	the same word of 8 lanes is together.
+	struct Lanes {
+
+		size_t count { 0 };
+
+		std::vector<int32_t> alive, input, events;
+		std::vector<int32_t> dir, headY, headX, tailY, tailX, foodY, foodX;
+		std::vector<int32_t> length, score, updateTime, headCrumb, tailCrumb;
+		std::vector<uint32_t> rng, seed, ticks, game;
+		std::vector<Policy> policy;
+		std::vector<uint32_t> occupied;		// A bit for each cell of the world.
+		std::vector<uint32_t> crumbs;		// The direction from each segment to the next.
+
+		explicit Lanes(size_t n) : count { n } {
+			for (auto* v : { &alive, &input, &events, &dir, &headY, &headX, &tailY, &tailX, &foodY, &foodX,
+							 &length, &score, &updateTime, &headCrumb, &tailCrumb })
+				v->assign(n, 0);
+			for (auto* v : { &rng, &seed, &ticks, &game }) v->assign(n, 0);
+			policy.assign(n, Policy::Random);
+			occupied.assign(n * OccupiedWords, 0);
+			crumbs.assign(n * CrumbWords, 0);
+		}
+	};
+
+	// The vector step.  For each live lane take the input, check the walls and the snake
+	//	and, if the head can move, move it.  The flags of GameEvents go in events.
+	using Kernel = void (*)(Lanes&);
+
+	void movePlain(Lanes& l) {
+
+		for (size_t i { 0 }; i < l.count; ++i) {
+
+			int32_t events { 0 };
+			if (l.alive[i]) {
+
+				const int32_t in { l.input[i] }, d0 { l.dir[i] };
+				const int32_t opposite { (d0 < None) ? (d0 ^ 3) : None };
+				if (in < None && in != d0 && in != opposite) l.dir[i] = in;
+
+				const int32_t d { l.dir[i] }, y { l.headY[i] }, x { l.headX[i] };
+				const bool wall { (d == Up && y == 0) || (d == Down && y == Height - 1) ||
+								  (d == Left && x == 0) || (d == Right && x == Width - 1) };
+
+				if (d == None) {}
+				else if (wall) events = GameEvents::HitWall;
+				else {
+					const int32_t ny { y + (d == Down) - (d == Up) }, nx { x + (d == Right) - (d == Left) };
+					const int32_t cell { ny * Width + nx };
+					const bool inSnake { ((l.occupied[(cell >> 5) * l.count + i] >> (cell & 31)) & 1) != 0 };
+
+					if (inSnake && cell != l.tailY[i] * Width + l.tailX[i]) events = GameEvents::HitSelf;
+					else {
+						events = GameEvents::Moved;
+						if (ny == l.foodY[i] && nx == l.foodX[i]) events |= GameEvents::Ate;
+						l.headY[i] = ny;
+						l.headX[i] = nx;
+					}
+				}
+			}
+			l.events[i] = events;
+		}
+	}
+
+#if BATCH_X86
+
+	__attribute__((target("sse4.1")))
+	inline __m128i load4(const std::vector<int32_t>& v, size_t i) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(v.data() + i)); }
+	__attribute__((target("sse4.1")))
+	inline void store4(std::vector<int32_t>& v, size_t i, __m128i a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(v.data() + i), a); }
+
+	// The same as movePlain 4 lanes at a time.  SSE has no gather or variable shift so the
+	//	bits of the new heads are looked up one lane at a time.
+	__attribute__((target("sse4.1")))
+	void moveSse(Lanes& l) {
+
+		const __m128i none { _mm_set1_epi32(None) }, three { _mm_set1_epi32(3) }, zero { _mm_setzero_si128() };
+		const __m128i left { _mm_set1_epi32(Left) }, right { _mm_set1_epi32(Right) };
+		const __m128i lastY { _mm_set1_epi32(Height - 1) }, lastX { _mm_set1_epi32(Width - 1) }, width { _mm_set1_epi32(Width) };
+
+		for (size_t i { 0 }; i < l.count; i += 4) {
+
+			const __m128i alive { load4(l.alive, i) }, in { load4(l.input, i) };
+			__m128i d { load4(l.dir, i) };
+
+			const __m128i opposite { _mm_blendv_epi8(none, _mm_xor_si128(d, three), _mm_cmpgt_epi32(none, d)) };
+			const __m128i reject { _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(in, three), _mm_cmpeq_epi32(in, d)), _mm_cmpeq_epi32(in, opposite)) };
+			d = _mm_blendv_epi8(d, in, _mm_andnot_si128(reject, alive));
+			store4(l.dir, i, d);
+
+			const __m128i moving { _mm_andnot_si128(_mm_cmpeq_epi32(d, none), alive) };
+			const __m128i up { _mm_cmpeq_epi32(d, zero) }, down { _mm_cmpeq_epi32(d, three) };
+			const __m128i goLeft { _mm_cmpeq_epi32(d, left) }, goRight { _mm_cmpeq_epi32(d, right) };
+			const __m128i y { load4(l.headY, i) }, x { load4(l.headX, i) };
+
+			const __m128i wall { _mm_and_si128(moving, _mm_or_si128(
+				_mm_or_si128(_mm_and_si128(up, _mm_cmpeq_epi32(y, zero)), _mm_and_si128(down, _mm_cmpeq_epi32(y, lastY))),
+				_mm_or_si128(_mm_and_si128(goLeft, _mm_cmpeq_epi32(x, zero)), _mm_and_si128(goRight, _mm_cmpeq_epi32(x, lastX))))) };
+			const __m128i step { _mm_andnot_si128(wall, moving) };
+
+			// The masks are -1 so up - down is the step in y.
+			const __m128i ny { _mm_add_epi32(y, _mm_sub_epi32(up, down)) }, nx { _mm_add_epi32(x, _mm_sub_epi32(goLeft, goRight)) };
+			const __m128i cell { _mm_and_si128(_mm_add_epi32(_mm_mullo_epi32(ny, width), nx), step) };
+
+			alignas(16) int32_t cells[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(cells), cell);
+			auto bit { [&](size_t k) {
+				return -static_cast<int32_t>((l.occupied[(cells[k] >> 5) * l.count + i + k] >> (cells[k] & 31)) & 1);
+			} };
+			const __m128i inSnake { _mm_setr_epi32(bit(0), bit(1), bit(2), bit(3)) };
+
+			const __m128i tail { _mm_add_epi32(_mm_mullo_epi32(load4(l.tailY, i), width), load4(l.tailX, i)) };
+			const __m128i self { _mm_and_si128(step, _mm_andnot_si128(_mm_cmpeq_epi32(cell, tail), inSnake)) };
+			const __m128i ok { _mm_andnot_si128(self, step) };
+			const __m128i ate { _mm_and_si128(ok, _mm_and_si128(_mm_cmpeq_epi32(ny, load4(l.foodY, i)), _mm_cmpeq_epi32(nx, load4(l.foodX, i)))) };
+
+			store4(l.events, i, _mm_or_si128(
+				_mm_or_si128(_mm_and_si128(ok, _mm_set1_epi32(GameEvents::Moved)), _mm_and_si128(ate, _mm_set1_epi32(GameEvents::Ate))),
+				_mm_or_si128(_mm_and_si128(wall, _mm_set1_epi32(GameEvents::HitWall)), _mm_and_si128(self, _mm_set1_epi32(GameEvents::HitSelf)))));
+			store4(l.headY, i, _mm_blendv_epi8(y, ny, ok));
+			store4(l.headX, i, _mm_blendv_epi8(x, nx, ok));
+		}
+	}
+
+	__attribute__((target("avx2")))
+	inline __m256i load8(const std::vector<int32_t>& v, size_t i) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v.data() + i)); }
+	__attribute__((target("avx2")))
+	inline void store8(std::vector<int32_t>& v, size_t i, __m256i a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(v.data() + i), a); }
+
+	// The same as movePlain 8 lanes at a time.  The bits of the new heads are gathered.
+	__attribute__((target("avx2")))
+	void moveAvx2(Lanes& l) {
+
+		const __m256i none { _mm256_set1_epi32(None) }, three { _mm256_set1_epi32(3) }, zero { _mm256_setzero_si256() };
+		const __m256i left { _mm256_set1_epi32(Left) }, right { _mm256_set1_epi32(Right) }, one { _mm256_set1_epi32(1) };
+		const __m256i lastY { _mm256_set1_epi32(Height - 1) }, lastX { _mm256_set1_epi32(Width - 1) }, width { _mm256_set1_epi32(Width) };
+		const __m256i stride { _mm256_set1_epi32(static_cast<int32_t>(l.count)) };
+		const __m256i lane { _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7) };
+
+		for (size_t i { 0 }; i < l.count; i += 8) {
+
+			const __m256i alive { load8(l.alive, i) }, in { load8(l.input, i) };
+			__m256i d { load8(l.dir, i) };
+
+			const __m256i opposite { _mm256_blendv_epi8(none, _mm256_xor_si256(d, three), _mm256_cmpgt_epi32(none, d)) };
+			const __m256i reject { _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(in, three), _mm256_cmpeq_epi32(in, d)), _mm256_cmpeq_epi32(in, opposite)) };
+			d = _mm256_blendv_epi8(d, in, _mm256_andnot_si256(reject, alive));
+			store8(l.dir, i, d);
+
+			const __m256i moving { _mm256_andnot_si256(_mm256_cmpeq_epi32(d, none), alive) };
+			const __m256i up { _mm256_cmpeq_epi32(d, zero) }, down { _mm256_cmpeq_epi32(d, three) };
+			const __m256i goLeft { _mm256_cmpeq_epi32(d, left) }, goRight { _mm256_cmpeq_epi32(d, right) };
+			const __m256i y { load8(l.headY, i) }, x { load8(l.headX, i) };
+
+			const __m256i wall { _mm256_and_si256(moving, _mm256_or_si256(
+				_mm256_or_si256(_mm256_and_si256(up, _mm256_cmpeq_epi32(y, zero)), _mm256_and_si256(down, _mm256_cmpeq_epi32(y, lastY))),
+				_mm256_or_si256(_mm256_and_si256(goLeft, _mm256_cmpeq_epi32(x, zero)), _mm256_and_si256(goRight, _mm256_cmpeq_epi32(x, lastX))))) };
+			const __m256i step { _mm256_andnot_si256(wall, moving) };
+
+			const __m256i ny { _mm256_add_epi32(y, _mm256_sub_epi32(up, down)) }, nx { _mm256_add_epi32(x, _mm256_sub_epi32(goLeft, goRight)) };
+			const __m256i cell { _mm256_and_si256(_mm256_add_epi32(_mm256_mullo_epi32(ny, width), nx), step) };
+
+			// Word cell / 32 of each lane then bit cell % 32 of it.
+			const __m256i index { _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(cell, 5), stride),
+												   _mm256_add_epi32(_mm256_set1_epi32(static_cast<int32_t>(i)), lane)) };
+			const __m256i words { _mm256_i32gather_epi32(reinterpret_cast<const int*>(l.occupied.data()), index, 4) };
+			const __m256i inSnake { _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srlv_epi32(words, _mm256_and_si256(cell, _mm256_set1_epi32(31))), one), one) };
+
+			const __m256i tail { _mm256_add_epi32(_mm256_mullo_epi32(load8(l.tailY, i), width), load8(l.tailX, i)) };
+			const __m256i self { _mm256_and_si256(step, _mm256_andnot_si256(_mm256_cmpeq_epi32(cell, tail), inSnake)) };
+			const __m256i ok { _mm256_andnot_si256(self, step) };
+			const __m256i ate { _mm256_and_si256(ok, _mm256_and_si256(_mm256_cmpeq_epi32(ny, load8(l.foodY, i)), _mm256_cmpeq_epi32(nx, load8(l.foodX, i)))) };
+
+			store8(l.events, i, _mm256_or_si256(
+				_mm256_or_si256(_mm256_and_si256(ok, _mm256_set1_epi32(GameEvents::Moved)), _mm256_and_si256(ate, _mm256_set1_epi32(GameEvents::Ate))),
+				_mm256_or_si256(_mm256_and_si256(wall, _mm256_set1_epi32(GameEvents::HitWall)), _mm256_and_si256(self, _mm256_set1_epi32(GameEvents::HitSelf)))));
+			store8(l.headY, i, _mm256_blendv_epi8(y, ny, ok));
+			store8(l.headX, i, _mm256_blendv_epi8(x, nx, ok));
+		}
+	}
+
+#endif // BATCH_X86
+
+
+	// Plays the games in the lanes.  The vector step then a pass over the lanes that moved
+	//	or ended.
+	class Simulator {
+	public:
+
+		struct Options {
+			uint32_t games { 10000 };
+			size_t lanes { 1024 };
+			uint32_t firstSeed { 1 };
+			Policy policy { Policy::Mixed };
+			uint32_t maxTicks { 10000 };
+		};
+
+		explicit Simulator(const Options& o) : options { o }, l { (o.lanes + 7) / 8 * 8 } {}
+
+		std::vector<Result> run(Kernel move) {
+
+			results.assign(options.games, Result {});
+			nextGame = 0;
+			for (size_t i { 0 }; i < l.count; ++i) start(i);
+
+			while (anyAlive) {
+				for (size_t i { 0 }; i < l.count; ++i)
+					if (l.alive[i]) l.input[i] = direction(l.policy[i], l.seed[i], l.ticks[i], l.headY[i], l.headX[i]);
+				move(l);
+				commit();
+			}
+			return results;
+		}
+
+	private:
+
+		Options options;
+		Lanes l;
+		std::vector<Result> results;
+		uint32_t nextGame { 0 };
+		bool anyAlive { false };
+
+		bool test(size_t i, int32_t cell) const { return (l.occupied[(cell >> 5) * l.count + i] >> (cell & 31)) & 1; }
+		void set(size_t i, int32_t cell) { l.occupied[(cell >> 5) * l.count + i] |= uint32_t{ 1 } << (cell & 31); }
+		void reset(size_t i, int32_t cell) { l.occupied[(cell >> 5) * l.count + i] &= ~(uint32_t{ 1 } << (cell & 31)); }
+
+		// Random::below() on the lane's state.
+		int32_t below(size_t i, uint16_t n) {
+			Random r { l.rng[i] };
+			const int32_t v { r.below(n) };
+			l.rng[i] = r.state;
+			return v;
+		}
+
+		// The same as GameCore::placeRandomScran().
+		bool placeFood(size_t i) {
+			if (l.length[i] >= Cells) return false;
+			do {
+				l.foodY[i] = below(i, Height);
+				l.foodX[i] = below(i, Width);
+			} while (test(i, l.foodY[i] * Width + l.foodX[i]));
+			return true;
+		}
+
+		// The same as GameCore::reset().  Lanes left when all the games have been
+		//	started are stopped.
+		void start(size_t i) {
+
+			if (nextGame == options.games) { l.alive[i] = 0; return; }
+
+			const uint32_t game { nextGame++ };
+			l.game[i] = game;
+			l.seed[i] = options.firstSeed + game;
+			l.policy[i] = policyOf(options.policy, game);
+			l.rng[i] = Random { l.seed[i] }.state;
+			l.ticks[i] = 0;
+			for (int32_t w { 0 }; w < OccupiedWords; ++w) l.occupied[w * l.count + i] = 0;
+
+			l.headY[i] = l.tailY[i] = below(i, Height);
+			l.headX[i] = l.tailX[i] = below(i, Width);
+			set(i, l.headY[i] * Width + l.headX[i]);
+			l.headCrumb[i] = l.tailCrumb[i] = 0;
+			l.length[i] = 1;
+			l.dir[i] = None;
+			l.score[i] = 0;
+			l.updateTime[i] = GameCore::updateTimeOnReset_ms;
+			placeFood(i);
+			l.alive[i] = -1;
+			anyAlive = true;
+		}
+
+		// The same as GameCore::checksum().  The world is small enough that the points
+		//	never have high bytes.
+		uint8_t checksum(size_t i) const {
+			uint8_t c { 0 };
+			auto mix { [&c](uint32_t b) { c = static_cast<uint8_t>(((c << 1) | (c >> 7)) ^ static_cast<uint8_t>(b)); } };
+			mix(l.headY[i]); mix(l.headX[i]);
+			mix(l.tailY[i]); mix(l.tailX[i]);
+			mix(l.length[i]); mix(l.length[i] >> 8);
+			mix(l.foodY[i]); mix(l.foodX[i]);
+			mix(l.score[i]); mix(l.score[i] >> 8);
+			for (uint8_t s { 0 }; s < 32; s += 8) mix(l.rng[i] >> s);
+			return c;
+		}
+
+		void finish(size_t i, Cause cause) {
+			Result& r { results[l.game[i]] };
+			r.seed = l.seed[i];
+			r.ticks = l.ticks[i];
+			r.score = static_cast<uint16_t>(l.score[i]);
+			r.length = static_cast<uint16_t>(l.length[i]);
+			r.cause = cause;
+			r.checksum = checksum(i);
+			start(i);
+		}
+
+		// The writes to one place in each lane.  The head is already moved.
+		void commit() {
+
+			anyAlive = false;
+			for (size_t i { 0 }; i < l.count; ++i) {
+
+				if (!l.alive[i]) continue;
+				++l.ticks[i];
+				int32_t events { l.events[i] };
+
+				if (events & GameEvents::Moved) {
+
+					// The crumb from the old head to the new one.
+					const int32_t h { l.headCrumb[i] };
+					uint32_t& word { l.crumbs[(h >> 4) * l.count + i] };
+					word = (word & ~(uint32_t{ 3 } << ((h & 15) * 2))) | (static_cast<uint32_t>(l.dir[i]) << ((h & 15) * 2));
+					l.headCrumb[i] = (h + 1 == RingSize) ? 0 : h + 1;
+
+					// The tail's bit goes before the head's is set so a head that moved in to
+					//	the old tail keeps its bit.
+					if (!(events & GameEvents::Ate)) {
+						reset(i, l.tailY[i] * Width + l.tailX[i]);
+						const int32_t t { l.tailCrumb[i] };
+						const int32_t d { static_cast<int32_t>((l.crumbs[(t >> 4) * l.count + i] >> ((t & 15) * 2)) & 3) };
+						l.tailY[i] += (d == Down) - (d == Up);
+						l.tailX[i] += (d == Right) - (d == Left);
+						l.tailCrumb[i] = (t + 1 == RingSize) ? 0 : t + 1;
+					}
+					else ++l.length[i];
+					set(i, l.headY[i] * Width + l.headX[i]);
+
+					if (events & GameEvents::Ate) {
+						l.score[i] += GameCore::scranScore;
+						if (l.score[i] % GameCore::speedUpEvery == 0) l.updateTime[i] -= l.updateTime[i] / GameCore::speedUpDivisor;
+						if (!placeFood(i)) events |= GameEvents::Won;
+					}
+				}
+
+				if (events & GameEvents::HitWall) finish(i, Cause::HitWall);
+				else if (events & GameEvents::HitSelf) finish(i, Cause::HitSelf);
+				else if (events & GameEvents::Won) finish(i, Cause::Won);
+				else if (l.ticks[i] == options.maxTicks) finish(i, Cause::TimedOut);
+
+				anyAlive = anyAlive || l.alive[i];
+			}
+		}
+	};
+
+
+	// *** Reporting ***
+
+	using Clock = std::chrono::steady_clock;
+
+	double secondsSince(Clock::time_point start) {
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	uint64_t totalTicks(const std::vector<Result>& results) {
+		uint64_t t { 0 };
+		for (const auto& r : results) t += r.ticks;
+		return t;
+	}
+
+	void printRate(const char* name, const std::vector<Result>& results, double seconds, double baseline) {
+		printf("%-16s %8.3f s %12.0f games/s %8.2fM ticks/s", name, seconds,
+			   results.size() / seconds, totalTicks(results) / seconds / 1e6);
+		if (baseline > 0) printf("  x%.1f", baseline / seconds);
+		printf("\n");
+	}
+
+	void printSummary(const std::vector<Result>& results) {
+
+		uint32_t causes[Causes] {};
+		uint64_t score { 0 }, length { 0 };
+		uint16_t maxScore { 0 }, maxLength { 0 };
+		for (const auto& r : results) {
+			++causes[static_cast<uint8_t>(r.cause)];
+			score += r.score; length += r.length;
+			if (r.score > maxScore) maxScore = r.score;
+			if (r.length > maxLength) maxLength = r.length;
+		}
+
+		const double n { results.empty() ? 1.0 : static_cast<double>(results.size()) };
+		printf("score mean %.1f max %u  length mean %.1f max %u  ticks %llu\n", score / n, maxScore,
+			   length / n, maxLength, static_cast<unsigned long long>(totalTicks(results)));
+		for (uint8_t c { 0 }; c < Causes; ++c)
+			printf("  %-18s %u\n", causeName(static_cast<Cause>(c)), causes[c]);
+	}
+
+	// The first game that is not the same or -1.
+	long firstMismatch(const std::vector<Result>& a, const std::vector<Result>& b) {
+		for (size_t i { 0 }; i < a.size(); ++i) if (a[i] != b[i]) return static_cast<long>(i);
+		return -1;
+	}
+
+	void printResult(const char* name, const Result& r) {
+		printf("  %-8s seed %lu ticks %lu score %u length %u %s checksum %02X\n", name,
+			   static_cast<unsigned long>(r.seed), static_cast<unsigned long>(r.ticks), r.score, r.length,
+			   causeName(r.cause), r.checksum);
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	using namespace Batch;
+
+	Simulator::Options options {};
+	std::string kernel { "all" };
+	const char* policyName { "mixed" };
+
+	for (int i { 1 }; i < argc; ++i) {
+		const std::string arg { argv[i] };
+		const bool hasValue { i + 1 < argc };
+		if (arg == "--games" && hasValue) options.games = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--lanes" && hasValue) options.lanes = strtoul(argv[++i], nullptr, 0);
+		else if (arg == "--seed" && hasValue) options.firstSeed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--max-ticks" && hasValue) options.maxTicks = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--kernel" && hasValue) kernel = argv[++i];
+		else if (arg == "--policy" && hasValue) {
+			policyName = argv[++i];
+			const std::string p { policyName };
+			if (p == "random") options.policy = Policy::Random;
+			else if (p == "cycle") options.policy = Policy::Cycle;
+			else if (p == "mixed") options.policy = Policy::Mixed;
+			else { fprintf(stderr, "Unknown policy %s\n", policyName); return 1; }
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--games n] [--lanes n] [--seed n] [--policy random|cycle|mixed]\n"
+							"          [--max-ticks n] [--kernel plain|sse|avx2|all]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (options.lanes == 0 || options.maxTicks == 0) {
+		fprintf(stderr, "--lanes and --max-ticks have to be more than 0.\n");
+		return 1;
+	}
+
+	struct { const char* name; Kernel move; bool supported; } kernels[] {
+		{ "plain", movePlain, true },
+#if BATCH_X86
+		{ "sse", moveSse, __builtin_cpu_supports("sse4.1") != 0 },
+		{ "avx2", moveAvx2, __builtin_cpu_supports("avx2") != 0 },
+#endif
+	};
+
+	printf("%u games  %zu lanes  policy %s  max ticks %u  seeds from %lu\n", options.games,
+		   (options.lanes + 7) / 8 * 8, policyName, options.maxTicks, static_cast<unsigned long>(options.firstSeed));
+
+	auto start { Clock::now() };
+	std::vector<Result> expected;
+	expected.reserve(options.games);
+	for (uint32_t g { 0 }; g < options.games; ++g)
+		expected.push_back(playGameCore(options.firstSeed + g, policyOf(options.policy, g), options.maxTicks));
+	const double scalarSeconds { secondsSince(start) };
+	printRate("GameCore", expected, scalarSeconds, 0);
+
+	int status { 0 };
+	bool ran { false };
+	Simulator simulator { options };
+	for (const auto& k : kernels) {
+
+		if (kernel != "all" && kernel != k.name) continue;
+		ran = true;
+		const std::string name { std::string("batch ") + k.name };
+		if (!k.supported) { printf("%-16s not supported by this CPU\n", name.c_str()); continue; }
+
+		start = Clock::now();
+		const auto results { simulator.run(k.move) };
+		printRate(name.c_str(), results, secondsSince(start), scalarSeconds);
+
+		const long bad { firstMismatch(expected, results) };
+		if (bad >= 0) {
+			printf("Game %ld does not match GameCore:\n", bad);
+			printResult("GameCore", expected[bad]);
+			printResult(k.name, results[bad]);
+			status = 2;
+		}
+	}
+	if (!ran) {
+		fprintf(stderr, "Unknown kernel %s\n", kernel.c_str());
+		return 1;
+	}
+
+	if (status == 0) printf("All %u games match GameCore.\n", options.games);
+	printSummary(expected);
+	return status;
+}
@@ -0,0 +1,226 @@
+// EEPROM check
+// Checks what is kept in the EEPROM on the host, with EepromWriter writing straight to
+//	the host EEPROM and the power cut part way through by EEPROM.writesLeft.
+//		High scores.  Adds random scores, clearing the table now and then, and for some of
+//		them does it first with the power going after fewer of the bytes.  The table loaded
+//		after a cut has to be the one from before, and after a whole add the new one.  Then saves enough tables
+//		for the sequence to go round several times and loads each one back.
+//		Snapshots.  Plays games and saves them now and then.  Each has to restore to the
+//		same game and play on the same as it.  A later save cut part way must restore
+//		nothing, or the one before if the cut came before any byte was written, and one
+//		that has been discarded nothing.
+//	Built by the eeprom_check environment in platformio.ini:
+//		pio run -e eeprom_check && .pio/build/eeprom_check/program [options]
+//
+//	Options:
+//		--adds <n>			High scores added.  20000 by default.
+//		--saves <n>			High score tables saved for the sequence to go round.  400000 by default.
+//		--games <n>			Games played for snapshots.  3000 by default.
+//		--seed <n>			Seed for the scores, cuts and games.
+
+#include <string>
+#include <EEPROM.h>
+#include "globals.hpp"
+#include "EepromLayout.hpp"
+#include "HighScores.hpp"
+#include "Snapshot.hpp"
+
+static_assert(PAUSE_SNAPSHOT == YES, "The EEPROM check needs the snapshot, which is for the screen sized world.");
+
+
+namespace Check {
+
+	struct Table {
+		uint16_t scores[HighScores::Entries];
+		bool operator==(const Table& o) const { return memcmp(scores, o.scores, sizeof(scores)) == 0; }
+		bool operator!=(const Table& o) const { return !(*this == o); }
+	};
+
+	Table table() {
+		Table t {};
+		for (uint8_t i { 0 }; i < HighScores::Entries; ++i) t.scores[i] = HighScores::score(i);
+		return t;
+	}
+
+	struct Results {
+		uint32_t checks { 0 };
+		uint32_t cuts { 0 };
+		uint32_t failures { 0 };
+	};
+
+	void fail(Results& r, const char* what, uint32_t at) {
+		if (r.failures++ < 10) fprintf(stderr, "%s at %u\n", what, at);
+	}
+
+	void erase() { memset(EEPROM.cells, 0xFF, sizeof(EEPROM.cells)); }
+
+	// Bytes written by f, which is then undone.
+	template <typename F>
+	uint32_t writesFor(F f) {
+		uint8_t before[sizeof(EEPROM.cells)];
+		memcpy(before, EEPROM.cells, sizeof(before));
+		const uint32_t start { EEPROM.writes };
+		f();
+		const uint32_t n { EEPROM.writes - start };
+		memcpy(EEPROM.cells, before, sizeof(before));
+		return n;
+	}
+
+	// Does f with the power going after written bytes.
+	template <typename F>
+	void cutAfter(uint32_t written, F f) {
+		EEPROM.writesLeft = static_cast<int32_t>(written);
+		f();
+		EEPROM.writesLeft = -1;
+	}
+
+	Results adds(uint32_t count, Random& random) {
+
+		Results r {};
+		erase();
+		HighScores::load();
+
+		for (uint32_t i { 0 }; i < count; ++i) {
+			// Cleared now and then so that most scores go in the table.
+			const uint16_t score { random.below(60000) };
+			const bool clearing { random.below(16) == 0 };
+			const auto change { [&] { if (clearing) HighScores::clear(); else HighScores::add(score); } };
+			const Table old { table() };
+
+			if (random.below(2) == 0) {
+				const uint32_t needed { writesFor(change) };
+				HighScores::load();
+				if (needed != 0) {
+					cutAfter(random.below(static_cast<uint16_t>(needed)), change);
+					HighScores::load();
+					if (table() != old) fail(r, "A cut add did not reload the table before it", i);
+					++r.cuts;
+				}
+			}
+
+			change();
+			const Table changed { table() };
+			HighScores::load();
+			if (table() != changed) fail(r, "An add did not load back", i);
+			++r.checks;
+		}
+		return r;
+	}
+
+	Results saves(uint32_t count) {
+
+		Results r {};
+		erase();
+		HighScores::load();
+
+		// Each add is a new best so each one saves the table.
+		uint16_t score { 0 };
+		for (uint32_t i { 0 }; i < count; ++i) {
+			if (score == 60000) {
+				HighScores::clear();
+				score = 0;
+			}
+			HighScores::add(++score);
+			const Table saved { table() };
+			HighScores::load();
+			if (table() != saved || HighScores::best() != score) fail(r, "A saved table did not load back", i);
+			++r.checks;
+		}
+		return r;
+	}
+
+	bool same(const GameCore& a, const GameCore& b) {
+		if (a.checksum() != b.checksum() || a.score() != b.score() || a.updateTime_ms() != b.updateTime_ms()
+			|| a.direction() != b.direction() || !(a.scran() == b.scran()) || a.random().state != b.random().state
+			|| a.level() != b.level() || a.snake().length() != b.snake().length()) return false;
+		SnakeType::Walker wa { a.snake() }, wb { b.snake() };
+		for (; !wa.done(); wa.next(), wb.next()) if (!(wa.point() == wb.point())) return false;
+		return true;
+	}
+
+	bool restores(GameCore& into) {
+		into.reset(1);
+		return Snapshot::restore(into);
+	}
+
+	Results snapshots(uint32_t games, Random& random) {
+
+		Results r {};
+		erase();
+
+		for (uint32_t g { 0 }; g < games; ++g) {
+			GameCore game {};
+			game.reset(random.next(), static_cast<uint8_t>(g % Levels::count));
+			Direction d { Direction::RIGHT };
+
+			while (true) {
+				if (random.below(4) == 0) d = static_cast<Direction>(random.below(4));
+				if (game.step(d).gameOver()) break;
+				if (random.below(8) != 0) continue;
+
+				Snapshot::save(game);
+				GameCore restored {};
+				if (!restores(restored) || !same(game, restored)) { fail(r, "A snapshot did not restore", g); continue; }
+
+				// Both play on the same.
+				GameCore on { game };
+				Random moves { random.next() };
+				for (uint16_t t { 0 }; t < 200; ++t) {
+					const Direction m { static_cast<Direction>(moves.below(4)) };
+					const GameEvents a { on.step(m) }, b { restored.step(m) };
+					if (a.flags != b.flags || !same(on, restored)) { fail(r, "A restored game played on differently", g); break; }
+					if (a.gameOver()) break;
+				}
+				++r.checks;
+
+				// A later save over this one with the power going part way.
+				if (random.below(4) == 0) {
+					const uint32_t needed { writesFor([&] { Snapshot::save(on); }) };
+					if (needed == 0) { fail(r, "A save wrote nothing", g); continue; }
+					const uint16_t written { random.below(static_cast<uint16_t>(needed)) };
+					cutAfter(written, [&] { Snapshot::save(on); });
+					// Only a cut before anything was written leaves the one before.
+					GameCore cut {};
+					if (restores(cut) && !(written == 0 && same(game, cut))) fail(r, "A cut snapshot restored", g);
+					++r.cuts;
+				}
+
+				Snapshot::discard();
+				GameCore discarded {};
+				if (restores(discarded)) fail(r, "A discarded snapshot restored", g);
+			}
+		}
+		return r;
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	using namespace Check;
+
+	uint32_t addCount { 20000 }, saveCount { 400000 }, games { 3000 }, seed { 1 };
+
+	for (int i { 1 }; i < argc; ++i) {
+		const std::string arg { argv[i] };
+		const bool hasValue { i + 1 < argc };
+		if (arg == "--adds" && hasValue) addCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--saves" && hasValue) saveCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--games" && hasValue) games = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--seed" && hasValue) seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else {
+			fprintf(stderr, "Usage: %s [--adds n] [--saves n] [--games n] [--seed n]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	Random random { seed };
+	const Results a { adds(addCount, random) };
+	printf("High score adds: %u checked, %u cut, %u failed\n", a.checks, a.cuts, a.failures);
+	const Results s { saves(saveCount) };
+	printf("High score saves: %u checked, %u failed\n", s.checks, s.failures);
+	const Results p { snapshots(games, random) };
+	printf("Snapshots: %u checked, %u cut, %u failed\n", p.checks, p.cuts, p.failures);
+
+	return (a.failures + s.failures + p.failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,455 @@
+// Lookahead
+// Plays games with a depth limited search and prints how fast it searched and how often
+//	the transposition table saved it from searching a position again.  Every position is
+//	made by GameCore::step() from the one before so the rules are exactly those of
+//	updateGame() and detectSelfCollision().
+//
+//	The search looks at every move to the given depth.  Where the scran is eaten it looks
+//	at a few places the next one could go and takes the worst of them.  A position scores
+//	256 for each move it survives plus up to 255 at the end for the room the snake has
+//	left, full marks if the whole snake fits.  At the top the move that scores most is
+//	taken and a tie goes to the shortest way to the scran.
+//
+//	Positions are hashed with Zobrist keys: a key for each cell with the head in it, for
+//	each cell with a segment in it and the way to the next segment, for the cell with the
+//	scran and for the direction.  The way to the next segment is needed as two snakes on
+//	the same cells in a different order are different positions.  A move changes a few of
+//	them so the hash is kept up to date with a few XORs rather than made again.
+//
+//	The table is one fixed block shared by all of the threads without locks.  An entry is
+//	two words, the data and the data XOR its key, the hash with the depth mixed in.  A
+//	thread that reads one while another writes it can get half of each, the check then
+//	fails and it is a miss, as if the entry was not there.  A value is only used at the
+//	same depth it was found at so the games are the same whatever is in the table, and the
+//	digest does not depend on the threads.  Each move is searched at depth 1 then 2 up to
+//	the depth asked for so the next move finds the shallower searches already done.
+//
+//	Built by the lookahead environment in platformio.ini:
+//		pio run -e lookahead && .pio/build/lookahead/program [options]
+//
+//	Options:
+//		--games <n>			Games to play.  32 by default.
+//		--threads <n>		Search threads.  One for each core by default.
+//		--seed <n>			Seed of the first game.
+//		--depth <n>			Moves to look ahead.  6 by default.
+//		--spawns <n>		Places tried for the next scran.  2 by default.
+//		--table-bits <n>	The table has 2^n entries of 16 bytes.  20 by default.
+//		--max-ticks <n>		Games still going after this many ticks are stopped.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "globals.hpp"
+#include "GameCore.hpp"
+#include "Bitboard.hpp"
+#include "Pathfinder.hpp"
+
+static_assert(LARGE_BOARD == NO, "The search plays the screen sized world.");
+
+
+namespace Lookahead {
+
+	constexpr uint8_t Height { World::ScreenWorld.height() };
+	constexpr uint8_t Width { World::ScreenWorld.width() };
+	constexpr uint16_t Cells { Height * Width };
+
+	constexpr uint32_t PlyScore { 256 };
+	constexpr uint32_t FullRoom { 255 };
+	constexpr uint8_t MaxDepth { 32 };
+	constexpr uint8_t MaxSpawns { 16 };
+
+	constexpr Direction directions[] { Direction::UP, Direction::LEFT, Direction::RIGHT, Direction::DOWN };
+
+	uint16_t cell(const PointType& p) { return static_cast<uint16_t>(p.y * Width + p.x); }
+
+	// The way from a to the cell next to it b.
+	Direction directionTo(const PointType& a, const PointType& b) {
+		if (b.y < a.y) return Direction::UP;
+		if (b.y > a.y) return Direction::DOWN;
+		return (b.x < a.x) ? Direction::LEFT : Direction::RIGHT;
+	}
+
+	uint64_t mix(uint64_t x) {
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+
+	// *** Zobrist hashing ***
+
+	class Zobrist {
+	public:
+
+		Zobrist() {
+			uint64_t n { 0 };
+			for (auto& k : m_head) k = mix(++n);
+			for (auto& c : m_segment) for (auto& k : c) k = mix(++n);
+			for (auto& k : m_scran) k = mix(++n);
+			for (auto& k : m_direction) k = mix(++n);
+		}
+
+		uint64_t head(const PointType& p) const { return m_head[cell(p)]; }
+		uint64_t segment(const PointType& p, Direction toNext) const { return m_segment[cell(p)][static_cast<uint8_t>(toNext)]; }
+		uint64_t scran(const PointType& p) const { return m_scran[cell(p)]; }
+		uint64_t direction(Direction d) const { return m_direction[static_cast<uint8_t>(d)]; }
+
+		// From nothing, for the start of a search.
+		uint64_t of(const GameCore& game) const {
+			uint64_t h { head(game.snake().head()) ^ scran(game.scran()) ^ direction(game.direction()) };
+			SnakeType::Walker w { game.snake() };
+			PointType p { w.point() };
+			for (w.next(); !w.done(); w.next()) {
+				h ^= segment(p, directionTo(p, w.point()));
+				p = w.point();
+			}
+			return h;
+		}
+
+		// After before.step() made after and what happened.  The scran is left as it was.
+		uint64_t update(uint64_t h, const GameCore& before, const GameCore& after, const GameEvents& events) const {
+			const PointType& oldHead { before.snake().head() };
+			h ^= direction(before.direction()) ^ direction(after.direction());
+			h ^= head(oldHead) ^ segment(oldHead, after.direction()) ^ head(events.head);
+			if (!events.has(GameEvents::Ate))
+				h ^= segment(events.removedTail, directionTo(events.removedTail, after.snake().tail()));
+			return h;
+		}
+
+	private:
+		uint64_t m_head[Cells];
+		uint64_t m_segment[Cells][4];
+		uint64_t m_scran[Cells];
+		uint64_t m_direction[5];
+	};
+
+
+	// *** Transposition table ***
+
+	// Fixed size and shared by every thread without locks.  See the top of the file.  A
+	//	position has an entry for each depth it is searched to so the shallow searches of
+	//	the next move do not push out the deep ones of this one.
+	class Table {
+	public:
+
+		explicit Table(uint8_t bits) : m_mask { (uint64_t { 1 } << bits) - 1 }, m_entries(size_t { 1 } << bits) {
+			for (uint8_t d { 0 }; d <= MaxDepth; ++d) m_depthKey[d] = mix(~uint64_t { d });
+		}
+
+		bool probe(uint64_t hash, uint8_t depth, uint32_t& value) const {
+			const uint64_t key { hash ^ m_depthKey[depth] };
+			const Entry& e { m_entries[key & m_mask] };
+			const uint64_t data { e.data.load(std::memory_order_relaxed) };
+			if ((e.check.load(std::memory_order_relaxed) ^ data) != key || depthOf(data) != depth) return false;
+			value = static_cast<uint32_t>(data);
+			return true;
+		}
+
+		// Always replaces what was there.
+		void store(uint64_t hash, uint8_t depth, uint32_t value) {
+			const uint64_t key { hash ^ m_depthKey[depth] };
+			Entry& e { m_entries[key & m_mask] };
+			const uint64_t data { (static_cast<uint64_t>(depth) << 32) | value };
+			e.data.store(data, std::memory_order_relaxed);
+			e.check.store(key ^ data, std::memory_order_relaxed);
+		}
+
+		size_t bytes() const { return m_entries.size() * sizeof(Entry); }
+
+	private:
+
+		struct Entry {
+			std::atomic<uint64_t> check { 0 };	// key ^ data.
+			std::atomic<uint64_t> data { 0 };	// depth << 32 | value.
+		};
+
+		static uint8_t depthOf(uint64_t data) { return static_cast<uint8_t>(data >> 32); }
+
+		const uint64_t m_mask;
+		uint64_t m_depthKey[MaxDepth + 1];
+		std::vector<Entry> m_entries;
+	};
+
+
+	// *** Search ***
+
+	struct Options {
+		uint32_t games { 32 };
+		unsigned threads { std::max(1u, std::thread::hardware_concurrency()) };
+		uint32_t firstSeed { 1 };
+		uint8_t depth { 6 };
+		uint8_t spawns { 2 };
+		uint8_t tableBits { 20 };
+		uint32_t maxTicks { 5000 };
+	};
+
+	struct Counts {
+		uint64_t nodes { 0 };
+		uint64_t probes { 0 };
+		uint64_t hits { 0 };
+		uint64_t stores { 0 };
+		uint64_t ticks { 0 };
+		uint64_t games { 0 };
+		uint64_t score { 0 };
+		uint64_t length { 0 };
+		uint32_t hitWall { 0 }, hitSelf { 0 }, won { 0 }, timedOut { 0 };
+		uint64_t digest { 0 };
+		double busySeconds { 0 };
+
+		Counts& operator+=(const Counts& o) {
+			nodes += o.nodes; probes += o.probes; hits += o.hits; stores += o.stores;
+			ticks += o.ticks; games += o.games; score += o.score; length += o.length;
+			hitWall += o.hitWall; hitSelf += o.hitSelf; won += o.won; timedOut += o.timedOut;
+			digest += o.digest;
+			return *this;
+		}
+	};
+
+	class Searcher {
+	public:
+
+		Searcher(const Options& o, const Zobrist& z, Table& t) : options { o }, zobrist { z }, table { t } {}
+
+		Direction choose(const GameCore& game);
+
+		Counts counts {};
+
+	private:
+
+		const Options& options;
+		const Zobrist& zobrist;
+		Table& table;
+
+		uint32_t search(const GameCore& game, uint64_t hash, uint8_t depth);
+		uint32_t afterMove(const GameCore& game, uint64_t hash, Direction d, uint8_t depth);
+		uint32_t room(const GameCore& game) const;
+	};
+
+	// Full marks if the whole snake fits in the most room any move leaves.
+	uint32_t Searcher::room(const GameCore& game) const {
+		const auto board { WorldBitboardGame::from(game) };
+		uint16_t most { 0 };
+		for (const auto d : directions) most = std::max(most, board.reachableAfter(d));
+		const uint16_t length { game.snake().length() };
+		return (most >= length) ? FullRoom : static_cast<uint32_t>(most) * FullRoom / length;
+	}
+
+	// The score of moving in d with depth moves to go.  0 if it ends the game.
+	uint32_t Searcher::afterMove(const GameCore& game, uint64_t hash, Direction d, uint8_t depth) {
+
+		GameCore next { game };
+		const GameEvents events { next.step(d) };
+		if (events.has(GameEvents::HitWall | GameEvents::HitSelf)) return 0;
+		if (events.has(GameEvents::Won)) return depth * PlyScore + FullRoom;
+
+		hash = zobrist.update(hash, game, next, events);
+		if (!events.has(GameEvents::Ate)) return PlyScore + search(next, hash, depth - 1);
+
+		// The next scran could go in any free cell.  Try a few picked by the hash so the
+		//	same position always tries the same ones, and take the worst.
+		uint16_t freeCells[Cells];
+		uint16_t count { 0 };
+		const auto snake { WorldBitboardGame::from(next) };
+		for (uint16_t i { 0 }; i < Cells; ++i) {
+			const PointType p { static_cast<POINT_DATA_TYPE>(i / Width), static_cast<POINT_DATA_TYPE>(i % Width) };
+			if (!snake.snake.test(p)) freeCells[count++] = i;
+		}
+		hash ^= zobrist.scran(next.scran());
+
+		uint32_t worst { UINT32_MAX };
+		for (uint8_t s { 0 }; s < options.spawns; ++s) {
+			const uint16_t i { freeCells[mix(hash + s) % count] };
+			const PointType p { static_cast<POINT_DATA_TYPE>(i / Width), static_cast<POINT_DATA_TYPE>(i % Width) };
+			next.setScran(p);
+			worst = std::min(worst, search(next, hash ^ zobrist.scran(p), depth - 1));
+		}
+		return PlyScore + worst;
+	}
+
+	uint32_t Searcher::search(const GameCore& game, uint64_t hash, uint8_t depth) {
+
+		++counts.nodes;
+		if (depth == 0) return room(game);
+
+		uint32_t value;
+		++counts.probes;
+		if (table.probe(hash, depth, value)) { ++counts.hits; return value; }
+
+		value = 0;
+		for (const auto d : directions) {
+			// step() takes going back the way it came as going on.
+			if (game.direction() != Direction::NONE && d == ~game.direction()) continue;
+			value = std::max(value, afterMove(game, hash, d, depth));
+		}
+
+		table.store(hash, depth, value);
+		++counts.stores;
+		return value;
+	}
+
+	Direction Searcher::choose(const GameCore& game) {
+
+		const uint64_t hash { zobrist.of(game) };
+		uint32_t values[4] {};
+		for (uint8_t depth { 1 }; depth <= options.depth; ++depth)
+			for (const auto d : directions) {
+				if (game.direction() != Direction::NONE && d == ~game.direction()) continue;
+				values[static_cast<uint8_t>(d)] = afterMove(game, hash, d, depth);
+			}
+
+		const uint32_t best { *std::max_element(values, values + 4) };
+		const auto path { WorldPathfinder::toScran(game) };
+		if (path.found() && values[static_cast<uint8_t>(path.first)] == best) return path.first;
+		for (const auto d : directions) if (values[static_cast<uint8_t>(d)] == best) return d;
+		return Direction::NONE;
+	}
+
+
+	// *** Games ***
+
+	class Pool {
+	public:
+
+		Pool(const Options& o) : options { o }, table { o.tableBits } {}
+
+		Counts run();
+		const std::vector<Counts>& threads() const { return perThread; }
+		const Table& sharedTable() const { return table; }
+
+	private:
+
+		const Options& options;
+		const Zobrist zobrist {};
+		Table table;
+		std::atomic<uint32_t> nextGame { 0 };
+		std::vector<Counts> perThread;
+
+		void work(size_t index);
+		void play(Searcher& searcher, uint32_t gameIndex);
+	};
+
+	void Pool::play(Searcher& searcher, uint32_t gameIndex) {
+
+		const uint32_t seed { options.firstSeed + gameIndex };
+		GameCore game {};
+		game.reset(seed);
+
+		GameEvents events {};
+		uint32_t ticks { 0 };
+		while (ticks < options.maxTicks) {
+			events = game.step(searcher.choose(game));
+			++ticks;
+			if (events.gameOver()) break;
+		}
+
+		Counts& c { searcher.counts };
+		++c.games;
+		c.ticks += ticks;
+		c.score += game.score();
+		c.length += game.snake().length();
+		if (events.has(GameEvents::HitWall)) ++c.hitWall;
+		else if (events.has(GameEvents::HitSelf)) ++c.hitSelf;
+		else if (events.has(GameEvents::Won)) ++c.won;
+		else ++c.timedOut;
+
+		// Added up so it is the same whichever thread played which game.
+		c.digest += mix((static_cast<uint64_t>(seed) << 32) ^ (static_cast<uint64_t>(ticks) << 8) ^ game.checksum());
+	}
+
+	void Pool::work(size_t index) {
+
+		Searcher searcher { options, zobrist, table };
+		const auto start { std::chrono::steady_clock::now() };
+		for (uint32_t g { nextGame.fetch_add(1) }; g < options.games; g = nextGame.fetch_add(1)) play(searcher, g);
+		searcher.counts.busySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		perThread[index] = searcher.counts;
+	}
+
+	Counts Pool::run() {
+
+		perThread.assign(options.threads, Counts {});
+		std::vector<std::thread> threads;
+		for (size_t i { 1 }; i < options.threads; ++i) threads.emplace_back(&Pool::work, this, i);
+		work(0);
+		for (auto& t : threads) t.join();
+
+		Counts total {};
+		for (const auto& c : perThread) total += c;
+		return total;
+	}
+
+
+	// *** Reporting ***
+
+	void print(const Counts& c, const Pool& pool, double seconds) {
+
+		const auto& threads { pool.threads() };
+		printf("\n%llu games in %.2f s on %zu threads, %llu nodes, %.0f nodes/s, %.0f nodes/s a thread\n",
+			   static_cast<unsigned long long>(c.games), seconds, threads.size(), static_cast<unsigned long long>(c.nodes),
+			   c.nodes / seconds, c.nodes / seconds / threads.size());
+		for (size_t i { 0 }; i < threads.size(); ++i) {
+			const auto& t { threads[i] };
+			printf("  thread %-3zu %6llu games %12llu nodes %10.0f nodes/s\n", i, static_cast<unsigned long long>(t.games),
+				   static_cast<unsigned long long>(t.nodes), (t.busySeconds > 0) ? t.nodes / t.busySeconds : 0.0);
+		}
+
+		printf("  %-18s %.1f MB, %llu probes, %llu hits, %.2f%% hit rate, %llu stores\n", "table",
+			   pool.sharedTable().bytes() / 1048576.0, static_cast<unsigned long long>(c.probes),
+			   static_cast<unsigned long long>(c.hits), (c.probes == 0) ? 0.0 : 100.0 * c.hits / c.probes,
+			   static_cast<unsigned long long>(c.stores));
+		printf("  %-18s %.1f ms a move\n", "search", (c.ticks == 0) ? 0.0 : 1000.0 * seconds * threads.size() / c.ticks);
+
+		const double n { (c.games == 0) ? 1.0 : static_cast<double>(c.games) };
+		printf("  %-18s %6.2f%%\n", "hit the wall", 100.0 * c.hitWall / n);
+		printf("  %-18s %6.2f%%\n", "hit itself", 100.0 * c.hitSelf / n);
+		printf("  %-18s %6.2f%%\n", "filled the board", 100.0 * c.won / n);
+		printf("  %-18s %6.2f%%\n", "timed out", 100.0 * c.timedOut / n);
+		printf("  %-18s mean %7.1f\n", "score", c.score / n);
+		printf("  %-18s mean %7.1f\n", "length", c.length / n);
+		printf("  %-18s %016llX  %llu ticks\n", "digest", static_cast<unsigned long long>(c.digest),
+			   static_cast<unsigned long long>(c.ticks));
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	using namespace Lookahead;
+
+	Options options {};
+	for (int i { 1 }; i < argc; ++i) {
+		const std::string arg { argv[i] };
+		const bool hasValue { i + 1 < argc };
+		if (arg == "--games" && hasValue) options.games = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--threads" && hasValue) options.threads = static_cast<unsigned>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--seed" && hasValue) options.firstSeed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--depth" && hasValue) options.depth = static_cast<uint8_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--spawns" && hasValue) options.spawns = static_cast<uint8_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--table-bits" && hasValue) options.tableBits = static_cast<uint8_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--max-ticks" && hasValue) options.maxTicks = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else {
+			fprintf(stderr, "Usage: %s [--games n] [--threads n] [--seed n] [--depth n] [--spawns n]\n"
+							"          [--table-bits n] [--max-ticks n]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (options.threads == 0 || options.depth == 0 || options.depth > MaxDepth ||
+		options.spawns == 0 || options.spawns > MaxSpawns || options.tableBits < 4 || options.tableBits > 30) {
+		fprintf(stderr, "--threads has to be more than 0, --depth 1 to %u, --spawns 1 to %u and --table-bits 4 to 30.\n",
+				MaxDepth, MaxSpawns);
+		return 1;
+	}
+
+	printf("%u games from seed %lu, depth %u, %u scran spawns, table of 2^%u entries\n", options.games,
+		   static_cast<unsigned long>(options.firstSeed), options.depth, options.spawns, options.tableBits);
+
+	Pool pool { options };
+	const auto start { std::chrono::steady_clock::now() };
+	const Counts total { pool.run() };
+	print(total, pool, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	return 0;
+}
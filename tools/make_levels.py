@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+# Makes src/LevelData.cpp from the level maps in levels/.
+#	python3 tools/make_levels.py [levels directory] [output file]
+#
+#	Each map is the 8 x 20 screen world, one of:
+#		.txt	A line for each row.  '#' or 'X' is a wall and '.' or ' ' is free.  Lines
+#				starting with ';' are comments.
+#		.pbm	A plain (P1) or raw (P4) bitmap.  1, black, is a wall.
+#	Levels come in the order of their file names after the open level 0.  The name shown
+#	on the splash screen is the file name without the number in front of it.
+#
+#	A map with no free cells, or free cells that cannot all be reached from each other,
+#	is an error as the scran could be put where the snake can never get to.
+
+import os
+import re
+import sys
+
+HEIGHT = 8
+WIDTH = 20
+ROW_BYTES = (WIDTH + 7) // 8
+NAME_LENGTH = 9     # Fits between the arrows on the splash screen.
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def fail(path, message):
+    sys.exit("{}: {}".format(path, message))
+
+
+def read_text(path):
+    rows = []
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+            if line.startswith(";"):
+                continue
+            if line.strip() == "" and not rows:
+                continue
+            if any(c not in "#X. " for c in line):
+                fail(path, "row {} has something other than '#', 'X', '.' or ' '".format(len(rows)))
+            rows.append([c in "#X" for c in line.ljust(WIDTH)])
+    while len(rows) > HEIGHT and not any(rows[-1]):
+        rows.pop()      # Blank lines at the end.
+    return rows
+
+
+def pbm_tokens(data):
+    # The header's numbers, skipping comments.  Returns them and where the data starts.
+    tokens, i = [], 2
+    while len(tokens) < 2:
+        while data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b"#":
+            while data[i:i + 1] not in (b"\n", b""):
+                i += 1
+            continue
+        start = i
+        while data[i:i + 1].isdigit():
+            i += 1
+        tokens.append(int(data[start:i]))
+    return tokens, i + 1
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    kind = data[:2]
+    if kind not in (b"P1", b"P4"):
+        fail(path, "not a P1 or P4 bitmap")
+    (width, height), start = pbm_tokens(data)
+    if kind == b"P1":
+        body = re.sub(rb"#[^\n]*", b"", data[start - 1:])
+        bits = [c == ord("1") for c in body if c in b"01"]
+        if len(bits) < width * height:
+            fail(path, "too few pixels")
+        return [bits[y * width:(y + 1) * width] for y in range(height)]
+    stride = (width + 7) // 8
+    body = data[start:]
+    if len(body) < stride * height:
+        fail(path, "too few pixels")
+    return [[(body[y * stride + x // 8] >> (7 - x % 8)) & 1 == 1 for x in range(width)] for y in range(height)]
+
+
+def check(path, rows):
+    if len(rows) != HEIGHT or any(len(r) != WIDTH for r in rows):
+        fail(path, "has to be {} rows of {}".format(HEIGHT, WIDTH))
+    free = [(y, x) for y in range(HEIGHT) for x in range(WIDTH) if not rows[y][x]]
+    if not free:
+        fail(path, "has no free cells")
+    seen, todo = {free[0]}, [free[0]]
+    while todo:
+        y, x = todo.pop()
+        for n in ((y - 1, x), (y + 1, x), (y, x - 1), (y, x + 1)):
+            if 0 <= n[0] < HEIGHT and 0 <= n[1] < WIDTH and not rows[n[0]][n[1]] and n not in seen:
+                seen.add(n)
+                todo.append(n)
+    if len(seen) != len(free):
+        fail(path, "has free cells that cannot be reached from the others")
+
+
+def level_name(path):
+    name = re.sub(r"^\d+[_-]?", "", os.path.splitext(os.path.basename(path))[0])
+    if not name or len(name) > NAME_LENGTH or not re.match(r"^[A-Za-z0-9 _-]+$", name):
+        fail(path, "the name has to be 1 to {} letters, numbers, spaces, '_' or '-'".format(NAME_LENGTH))
+    return name
+
+
+def c_bytes(values):
+    return ", ".join("0x{:02X}".format(v) for v in values)
+
+
+def main():
+    levels_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(HERE, "..", "levels")
+    output = sys.argv[2] if len(sys.argv) > 2 else os.path.join(HERE, "..", "src", "LevelData.cpp")
+
+    files = sorted(f for f in os.listdir(levels_dir) if f.endswith((".txt", ".pbm")))
+    if len(files) > 15:
+        sys.exit("No more than 15 levels fit in a replay.")
+
+    out = ["// Made by tools/make_levels.py from the maps in levels/.  Do not edit.",
+           "#include \"Levels.hpp\"",
+           "",
+           "namespace {",
+           "",
+           "\tconst char openName[] PROGMEM { \"open\" };"]
+    entries = ["\t\t{ nullptr, nullptr, Cells, openName },"]
+
+    for i, f in enumerate(files, 1):
+        path = os.path.join(levels_dir, f)
+        rows = read_pbm(path) if f.endswith(".pbm") else read_text(path)
+        check(path, rows)
+        name = level_name(path)
+
+        walls, before, free = [], [], 0
+        for row in rows:
+            before.append(free)
+            free += row.count(False)
+            for b in range(ROW_BYTES):
+                walls.append(sum(1 << k for k in range(8) if b * 8 + k < WIDTH and row[b * 8 + k]))
+
+        out += ["",
+                "\t// {} from {}".format(name, f)]
+        out += ["\t//\t" + "".join("#" if c else "." for c in row) for row in rows]
+        out += ["\tconst uint8_t walls{}[] PROGMEM {{ {} }};".format(i, c_bytes(walls)),
+                "\tconst uint8_t rows{}[] PROGMEM {{ {} }};".format(i, ", ".join(str(v) for v in before)),
+                "\tconst char name{}[] PROGMEM {{ \"{}\" }};".format(i, name)]
+        entries.append("\t\t{{ walls{0}, rows{0}, {1}, name{0} }},".format(i, free))
+
+    out += ["",
+            "\tstatic_assert(Levels::Height == {} && Levels::Width == {}, \"Run tools/make_levels.py again for this size of world.\");".format(HEIGHT, WIDTH),
+            "}",
+            "",
+            "",
+            "namespace Levels {",
+            "",
+            "\tconst Level table[] PROGMEM {"]
+    out += entries
+    out += ["\t};",
+            "",
+            "\tconst uint8_t count { sizeof(table) / sizeof(table[0]) };",
+            "}",
+            ""]
+
+    with open(output, "w") as f:
+        f.write("\n".join(out))
+    print("{} levels written to {}".format(len(files) + 1, os.path.relpath(output)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,155 @@
+# Memory budget report for the uno build.
+# Run by PlatformIO after the ELF is linked (see extra_scripts in platformio.ini).
+#	Lists how much flash (.text), initialised RAM (.data) and zeroed RAM (.bss) each
+#	translation unit and symbol takes in the linked firmware and writes it all to
+#	$BUILD_DIR/memory_report.json.  The report from the build before is kept as
+#	memory_report.previous.json and the differences are printed so changes that save
+#	(or cost) memory show up straight away.
+
+Import("env")
+
+import json
+import os
+import re
+import shutil
+import subprocess
+
+FLASH_TOTAL = 32256     # 32 KB less the 512 byte bootloader.
+RAM_TOTAL = 2048
+DISPLAY_BUFFER = 128 * 64 // 8  # Allocated by Adafruit_SSD1306::begin() on the heap.
+
+# Symbols that are always listed whatever their size.
+HIGHLIGHTS = [r"^snake$", r"^Display::display$", r"^Buttons::", r"^Snake<", r"^RingBuffer<",
+              r"^CrumbPtr::", r"^World::", r"^Score::", r"^Timing::", r"^lastDirectionPressed$"]
+
+SECTIONS = {".text": "text", ".data": "data", ".bss": "bss", ".noinit": "bss"}
+NM_TYPES = {"t": "text", "w": "text", "d": "data", "b": "bss", "v": "bss"}
+
+MAP_FILE = env.subst("$BUILD_DIR/firmware.map")
+env.Append(LINKFLAGS=["-Wl,-Map," + MAP_FILE])
+
+
+def unit_name(path):
+    # Make the object paths short and the same from one machine to the next.
+    path = path.replace("\\", "/")
+    m = re.search(r"\(([^)]+)\)$", path)  # Member of an archive.
+    if m:
+        path = os.path.basename(path.split("(")[0]) + ":" + m.group(1)
+    path = re.sub(r"^.*?\.pio/build/[^/]+/", "", path)
+    path = re.sub(r"^.*/toolchain-atmelavr/", "toolchain/", path)
+    return path
+
+
+def units_from_map(path):
+    units = {}
+    output = None
+    started = False
+    pending = None
+    with open(path) as f:
+        for line in f:
+            if line.startswith("Linker script and memory map"):
+                started = True
+                continue
+            if not started:
+                continue
+            m = re.match(r"^(\.\S+)\s", line)
+            if m:
+                output = SECTIONS.get(m.group(1))
+                continue
+            if output is None:
+                continue
+            m = re.match(r"^ (\.\S+|COMMON)\s*$", line)
+            if m:
+                pending = m.group(1)  # Name on its own line, address on the next.
+                continue
+            m = re.match(r"^ (\.\S+|COMMON)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*\.o\S*)\s*$", line)
+            if m and (m.group(1) or pending):
+                size = int(m.group(3), 16)
+                if size:
+                    u = units.setdefault(unit_name(m.group(4)), {"text": 0, "data": 0, "bss": 0})
+                    u[output] += size
+            pending = None
+    return units
+
+
+def symbols_from_elf(nm, elf):
+    out = subprocess.run([nm, "-C", "-S", "--size-sort", "-t", "d", elf],
+                         stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+    symbols = []
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) != 4:
+            continue
+        kind = NM_TYPES.get(parts[2].lower())
+        if kind:
+            symbols.append({"name": parts[3], "section": kind, "size": int(parts[1])})
+    symbols.sort(key=lambda s: -s["size"])
+    return symbols
+
+
+def print_changes(old, new):
+    changes = []
+    for key in ("text", "data", "bss", "static_ram", "ram_left_for_stack"):
+        delta = new["totals"][key] - old["totals"][key]
+        if delta:
+            changes.append("  %-24s %+6d" % (key, delta))
+    for name in sorted(set(old["units"]) | set(new["units"])):
+        a = old["units"].get(name, {"text": 0, "data": 0, "bss": 0})
+        b = new["units"].get(name, {"text": 0, "data": 0, "bss": 0})
+        d = ["%s %+d" % (k, b[k] - a[k]) for k in ("text", "data", "bss") if b[k] != a[k]]
+        if d:
+            changes.append("  %-40s %s" % (name, ", ".join(d)))
+    print("Changes since the last build:" if changes else "No change in memory use since the last build.")
+    for c in changes:
+        print(c)
+
+
+def nm_tool(env):
+    # nm is next to size in the toolchain and named the same but for the end, as in
+    # avr-size and avr-nm.  Only the end of the file name is changed, not the path.
+    folder, name = os.path.split(env.subst("$SIZETOOL"))
+    stem, ext = os.path.splitext(name)
+    if not stem.endswith("size"):
+        return "avr-nm"
+    return os.path.join(folder, stem[:-len("size")] + "nm" + ext)
+
+
+def memory_report(source, target, env):
+    elf = str(target[0])
+    nm = nm_tool(env)
+    build_dir = env.subst("$BUILD_DIR")
+
+    units = units_from_map(MAP_FILE) if os.path.isfile(MAP_FILE) else {}
+    symbols = symbols_from_elf(nm, elf)
+
+    totals = {k: sum(s["size"] for s in symbols if s["section"] == k) for k in ("text", "data", "bss")}
+    if units:
+        totals = {k: sum(u[k] for u in units.values()) for k in ("text", "data", "bss")}
+    totals["flash"] = totals["text"] + totals["data"]
+    totals["static_ram"] = totals["data"] + totals["bss"]
+    totals["ram_left_for_stack"] = RAM_TOTAL - totals["static_ram"] - DISPLAY_BUFFER
+
+    highlights = [s for s in symbols if any(re.search(h, s["name"]) for h in HIGHLIGHTS)]
+    report = {"totals": totals, "units": units, "highlights": highlights, "symbols": symbols}
+
+    print("Flash %d of %d bytes.  RAM %d static + %d display buffer of %d, leaving %d for the stack." % (
+        totals["flash"], FLASH_TOTAL, totals["static_ram"], DISPLAY_BUFFER, RAM_TOTAL, totals["ram_left_for_stack"]))
+    print("%-40s %7s %6s %6s" % ("translation unit", "text", "data", "bss"))
+    for name, u in sorted(units.items(), key=lambda i: -(i[1]["data"] + i[1]["bss"] + i[1]["text"])):
+        print("%-40s %7d %6d %6d" % (name[-40:], u["text"], u["data"], u["bss"]))
+    print("%-56s %5s %6s" % ("symbol", "sect", "size"))
+    for s in highlights + [s for s in symbols if s["section"] != "text" and s not in highlights][:10]:
+        print("%-56s %5s %6d" % (s["name"][:56], s["section"], s["size"]))
+
+    path = os.path.join(build_dir, "memory_report.json")
+    previous = os.path.join(build_dir, "memory_report.previous.json")
+    if os.path.isfile(path):
+        shutil.copyfile(path, previous)
+        with open(previous) as f:
+            print_changes(json.load(f), report)
+    with open(path, "w") as f:
+        json.dump(report, f, indent=1)
+    print("Memory report written to %s" % path)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", memory_report)
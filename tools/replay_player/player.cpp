@@ -0,0 +1,177 @@
+// Replay player
+// Plays back a replay recorded by the firmware (RECORD_REPLAY in globals.hpp) through
+//	the same GameCore the game uses and checks each block's checksum on the way.  A
+//	mismatch gives the first bad block and the ticks in it.
+//	Built by the replay_player environment in platformio.ini:
+//		pio run -e replay_player && .pio/build/replay_player/program [options] <replay>
+//	The replay can be a binary file, a saved serial log with a "REPLAY <hex>" line in it
+//	or a dump of the EEPROM with --offset 768 (EepromLayout::replay).
+//
+//	Options:
+//		--offset <n>	Start reading the binary file at byte n.
+//		--frames		Print the board after every tick.
+//		--every <n>		Print the board every n ticks.
+//		--quiet			Only print the summary.
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "globals.hpp"
+#include "GameCore.hpp"
+#include "Replay.hpp"
+
+
+namespace Player {
+
+	struct Options {
+		const char* path { nullptr };
+		long offset { 0 };
+		unsigned every { 0 };
+		bool quiet { false };
+	};
+
+	int hexValue(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	// The last "REPLAY " line in the text or, if there is not one, the bytes as they are.
+	std::vector<uint8_t> decode(const std::vector<uint8_t>& file, long offset) {
+
+		const std::string text(file.begin(), file.end());
+		const auto at { text.rfind("REPLAY ") };
+		if (at == std::string::npos) {
+			if (offset < 0 || static_cast<size_t>(offset) > file.size()) return {};
+			return { file.begin() + offset, file.end() };
+		}
+
+		std::vector<uint8_t> bytes;
+		for (size_t i { at + 7 }; i + 1 < text.size(); i += 2) {
+			const int hi { hexValue(text[i]) }, lo { hexValue(text[i + 1]) };
+			if (hi < 0 || lo < 0) break;
+			bytes.push_back(static_cast<uint8_t>((hi << 4) | lo));
+		}
+		return bytes;
+	}
+
+	void printBoard(const GameCore& game, uint16_t tick) {
+
+		using World::World;
+		std::vector<std::string> rows(World.height(), std::string(World.width(), '.'));
+		auto put { [&rows](const PointType& p, char c) {
+			if (p.y < World.height() && p.x < World.width()) rows[p.y][p.x] = c;
+		} };
+
+		if (game.level() != 0) {
+			const uint8_t* walls { Levels::walls(game.level()) };
+			for (uint8_t y { 0 }; y < World.height(); ++y)
+				for (uint8_t x { 0 }; x < World.width(); ++x)
+					if (Levels::wall(walls, PointType { y, x })) rows[y][x] = '#';
+		}
+
+		const auto& snake { game.snake() };
+		for (uint16_t i { 0 }; i < snake.length(); ++i) put(snake[i], 'o');
+		put(snake.head(), '@');
+		put(game.scran(), '*');
+
+		printf("tick %u  score %u  length %u\n", tick, game.score(), snake.length());
+		printf("+%s+\n", std::string(World.width(), '-').c_str());
+		for (const auto& row : rows) printf("|%s|\n", row.c_str());
+		printf("+%s+\n", std::string(World.width(), '-').c_str());
+	}
+
+	const char* causeOf(const GameEvents& events) {
+		if (events.has(GameEvents::HitWall)) return "hit the wall";
+		if (events.has(GameEvents::HitSelf)) return "hit itself";
+		if (events.has(GameEvents::Won)) return "filled the board";
+		return nullptr;
+	}
+
+	int play(const Replay::Reader& replay, const Options& options) {
+
+		GameCore game {};
+		game.reset(replay.seed(), replay.level());
+
+		GameEvents events {};
+		uint16_t tick { 0 };
+		const auto start { std::chrono::steady_clock::now() };
+
+		for (; tick < replay.ticks(); ++tick) {
+
+			events = game.step(replay.direction(tick));
+
+			if (replay.hasChecksum(tick) && game.checksum() != replay.checksum(tick)) {
+				printBoard(game, tick);
+				fprintf(stderr, "Checksum mismatch in block %u, ticks %u to %u: replay %02X, game %02X.\n",
+						replay.block(tick), replay.blockStart(tick), tick, replay.checksum(tick), game.checksum());
+				fprintf(stderr, "Run with --frames to see the board after each of them.\n");
+				return 2;
+			}
+			// The recording stops when the game does, so ending sooner is a mismatch too.
+			if (events.gameOver() && tick + 1 < replay.ticks()) {
+				printBoard(game, tick);
+				fprintf(stderr, "The game ended at tick %u in block %u, ticks %u to %u, with %u ticks of the replay left.\n",
+						tick, replay.block(tick), replay.blockStart(tick), tick, replay.ticks() - tick - 1);
+				return 2;
+			}
+			if (!options.quiet && options.every != 0 && tick % options.every == 0) printBoard(game, tick);
+			if (events.gameOver()) { ++tick; break; }
+		}
+
+		const double seconds { std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+		if (!options.quiet) printBoard(game, tick);
+		// Flash is ordinary memory on the host.
+		if (game.level() != 0) printf("level %u %s\n", game.level(), reinterpret_cast<const char*>(Levels::name(game.level())));
+		printf("seed %08lX  ticks %u of %u  score %u  length %u\n", static_cast<unsigned long>(replay.seed()),
+			   tick, replay.ticks(), game.score(), game.snake().length());
+
+		const char* cause { causeOf(events) };
+		if (cause != nullptr) printf("The snake %s.\n", cause);
+		else if (replay.flags() & Replay::truncated) printf("The recording ran out of room before the game ended.\n");
+		else printf("The game was still going at the end of the recording.\n");
+
+		if (seconds > 0) printf("%.0f ticks per second.\n", tick / seconds);
+		return 0;
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	Player::Options options {};
+
+	for (int i { 1 }; i < argc; ++i) {
+		const std::string arg { argv[i] };
+		if (arg == "--offset" && i + 1 < argc) options.offset = strtol(argv[++i], nullptr, 0);
+		else if (arg == "--every" && i + 1 < argc) options.every = static_cast<unsigned>(atoi(argv[++i]));
+		else if (arg == "--frames") options.every = 1;
+		else if (arg == "--quiet") options.quiet = true;
+		else options.path = argv[i];
+	}
+
+	if (options.path == nullptr) {
+		fprintf(stderr, "Usage: %s [--offset n] [--frames | --every n] [--quiet] <replay>\n", argv[0]);
+		return 1;
+	}
+
+	FILE* f { fopen(options.path, "rb") };
+	if (f == nullptr) {
+		fprintf(stderr, "Could not open %s\n", options.path);
+		return 1;
+	}
+	std::vector<uint8_t> file;
+	for (int c { fgetc(f) }; c != EOF; c = fgetc(f)) file.push_back(static_cast<uint8_t>(c));
+	fclose(f);
+
+	const auto bytes { Player::decode(file, options.offset) };
+	const Replay::Reader replay { bytes.data(), static_cast<uint16_t>(bytes.size() < 0xFFFF ? bytes.size() : 0xFFFF) };
+	if (!replay.valid()) {
+		fprintf(stderr, "%s does not hold a replay.\n", options.path);
+		return 1;
+	}
+
+	return Player::play(replay, options);
+}
@@ -0,0 +1,488 @@
+// Self-play farm
+// Plays batches of games through GameCore with an AI on every core and prints what
+//	happened: how the games ended and histograms of the score, the length and how long
+//	the game would have lasted on the device.  Run it before and after changing the rules
+//	in GameCore (scranScore, speedUpEvery, speedUpDivisor, updateTimeOnReset_ms) to see
+//	what the change does to the balance.
+//
+//	Game n is played with seed first + n and the AI's own random numbers come from the
+//	same seed so the results do not depend on the number of threads.  The digest at the
+//	end of each policy changes if any game went differently.
+//
+//	Each thread owns a range of games and takes a chunk at a time from the front of it.
+//	A thread with nothing left steals the back half of another's range.  Both are one
+//	compare and swap on the range so there are no locks.  Everything a thread uses, its
+//	GameCore and its histograms, is made before it starts and kept on its own cache lines.
+//	Nothing is allocated while the games are played.
+//
+//	Built by the selfplay_farm environment in platformio.ini:
+//		pio run -e selfplay_farm && .pio/build/selfplay_farm/program [options]
+//
+//	Options:
+//		--games <n>			Games for each policy.  100000 by default.
+//		--threads <n>		Worker threads.  One for each core by default.
+//		--seed <n>			Seed of the first game.
+//		--policy <p,...>	Any of random, greedy, flood, path, cycle and autopilot.  greedy,flood
+//							by default.
+//		--max-ticks <n>		Games still going after this many ticks are stopped.
+//		--chunk <n>			Games taken at a time.  64 by default.
+//		--csv <file>		Write the histograms to file.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "globals.hpp"
+#include "GameCore.hpp"
+#include "Bitboard.hpp"
+#include "Autopilot.hpp"
+#include "Pathfinder.hpp"
+
+static_assert(LARGE_BOARD == NO, "The farm plays the screen sized world.");
+
+
+namespace Farm {
+
+	constexpr uint16_t Cells { World::ScreenWorld.height() * World::ScreenWorld.width() };
+	constexpr uint16_t SecondsPerBin { 10 };
+	constexpr uint16_t SecondsBins { 60 };		// Up to 10 minutes, the last bin is for longer.
+
+	enum class Policy : uint8_t { Random, Greedy, Flood, Path, Cycle, Autopilot };
+
+	enum class Cause : uint8_t { HitWall, HitSelf, Won, TimedOut };
+	constexpr uint8_t Causes { 4 };
+
+	const char* causeName(Cause c) {
+		switch (c) {
+			case Cause::HitWall: 	return "hit the wall";
+			case Cause::HitSelf: 	return "hit itself";
+			case Cause::Won: 		return "filled the board";
+			default: 				return "timed out";
+		}
+	}
+
+	const char* policyName(Policy p) {
+		switch (p) {
+			case Policy::Random: 	return "random";
+			case Policy::Greedy: 	return "greedy";
+			case Policy::Flood: 	return "flood";
+			case Policy::Path: 		return "path";
+			case Policy::Cycle: 	return "cycle";
+			default: 				return "autopilot";
+		}
+	}
+
+
+	// *** Policies ***
+	// An AI looks at the game and gives the direction to press.  They only use the game and
+	//	their own random numbers so a game depends only on its seed.
+
+	constexpr Direction directions[] { Direction::UP, Direction::LEFT, Direction::RIGHT, Direction::DOWN };
+
+	// A move that does not end the game.  Going back the way it came is not a move as
+	//	step() ignores it.
+	bool safe(const GameCore& game, Direction d) {
+		if (game.direction() != Direction::NONE && d == ~game.direction()) return false;
+		const PointType& head { game.snake().head() };
+		return !game.detectPlayerOutOfArea(head, d) && !game.detectSelfCollision(movePoint(head, d));
+	}
+
+	uint16_t distance(const PointType& a, const PointType& b) {
+		return static_cast<uint16_t>(abs(static_cast<int>(a.y) - b.y) + abs(static_cast<int>(a.x) - b.x));
+	}
+
+	// Any safe move.
+	Direction randomPolicy(const GameCore& game, Random& random) {
+		Direction moves[4];
+		uint8_t n { 0 };
+		for (const auto d : directions) if (safe(game, d)) moves[n++] = d;
+		return (n == 0) ? Direction::NONE : moves[random.below(n)];
+	}
+
+	// The safe move that gets closest to the scran.
+	Direction greedyPolicy(const GameCore& game, Random&) {
+		Direction best { Direction::NONE };
+		uint16_t bestDistance { 0xFFFF };
+		for (const auto d : directions) {
+			if (!safe(game, d)) continue;
+			const uint16_t to { distance(movePoint(game.snake().head(), d), game.scran()) };
+			if (to < bestDistance) { best = d; bestDistance = to; }
+		}
+		return best;
+	}
+
+	// Like greedy but only into the largest space left so it does not shut itself in.
+	Direction floodPolicy(const GameCore& game, Random&) {
+		const auto board { WorldBitboardGame::from(game) };
+		Direction best { Direction::NONE };
+		uint16_t bestRoom { 0 }, bestDistance { 0xFFFF };
+		for (const auto d : directions) {
+			const uint16_t room { board.reachableAfter(d) };
+			if (room == 0) continue;
+			const uint16_t to { distance(movePoint(game.snake().head(), d), game.scran()) };
+			if (room > bestRoom || (room == bestRoom && to < bestDistance)) { best = d; bestRoom = room; bestDistance = to; }
+		}
+		return best;
+	}
+
+	// The shortest way to the scran when the first move leaves room for the whole snake
+	//	as it is now.  Else like flood with the room once the tail has moved on to break
+	//	ties.
+	Direction pathPolicy(const GameCore& game, Random&) {
+		const auto board { WorldBitboardGame::from(game) };
+		const auto path { WorldPathfinder::toScran(game) };
+		if (path.found() && board.reachableAfter(path.first) >= game.snake().length()) return path.first;
+		Direction best { Direction::NONE };
+		uint16_t bestRoom { 0 }, bestLater { 0 };
+		for (const auto d : directions) {
+			const uint16_t room { board.reachableAfter(d) };
+			if (room == 0) continue;
+			const uint16_t later { WorldPathfinder::reachableAfter(game, d) };
+			if (room > bestRoom || (room == bestRoom && later > bestLater)) { best = d; bestRoom = room; bestLater = later; }
+		}
+		return best;
+	}
+
+	// Round the Hamiltonian cycle.  Never dies, fills the board in the end.
+	Direction cyclePolicy(const GameCore& game, Random&) {
+		constexpr auto height { World::ScreenWorld.height() }, width { World::ScreenWorld.width() };
+		static_assert(height % 2 == 0, "The cycle needs an even number of rows.");
+		const PointType& p { game.snake().head() };
+		if (p.x == 0) return (p.y == 0) ? Direction::RIGHT : Direction::UP;
+		if (p.y % 2 == 1) {
+			if (p.x > 1) return Direction::LEFT;
+			return (p.y == height - 1) ? Direction::LEFT : Direction::DOWN;
+		}
+		return (p.x < width - 1) ? Direction::RIGHT : Direction::DOWN;
+	}
+
+	// The firmware's autopilot.  The cycle with safe short cuts.  Not timed as the
+	//	cycle counts are shared by every thread.
+	Direction autopilotPolicy(const GameCore& game, Random&) { return Autopilot::decide(game); }
+
+	using PolicyFunction = Direction (*)(const GameCore&, Random&);
+
+	PolicyFunction policyFunction(Policy p) {
+		switch (p) {
+			case Policy::Random: 	return randomPolicy;
+			case Policy::Greedy: 	return greedyPolicy;
+			case Policy::Flood: 	return floodPolicy;
+			case Policy::Path: 		return pathPolicy;
+			case Policy::Cycle: 	return cyclePolicy;
+			default: 				return autopilotPolicy;
+		}
+	}
+
+
+	// *** Statistics ***
+
+	// Fixed size histograms so adding a game never allocates.
+	struct Stats {
+
+		uint64_t games { 0 };
+		uint64_t ticks { 0 };
+		uint32_t causes[Causes] {};
+		uint32_t scrans[Cells + 1] {};			// Score / GameCore::scranScore.
+		uint32_t lengths[Cells + 1] {};
+		uint32_t seconds[SecondsBins + 1] {};	// How long the game would take on the device.
+		uint64_t digest { 0 };
+
+		void add(uint32_t seed, uint32_t ticks, const GameCore& game, Cause cause, uint32_t played_ms);
+		Stats& operator+=(const Stats& o);
+	};
+
+	void Stats::add(uint32_t seed, uint32_t gameTicks, const GameCore& game, Cause cause, uint32_t played_ms) {
+		++games;
+		ticks += gameTicks;
+		++causes[static_cast<uint8_t>(cause)];
+		++scrans[std::min<uint32_t>(game.score() / GameCore::scranScore, Cells)];
+		++lengths[std::min<uint32_t>(game.snake().length(), Cells)];
+		++seconds[std::min<uint32_t>(played_ms / 1000 / SecondsPerBin, SecondsBins)];
+
+		// Added up so it is the same whichever thread played which game.
+		uint64_t h { (static_cast<uint64_t>(seed) << 32) ^ (static_cast<uint64_t>(gameTicks) << 8) ^ game.checksum() };
+		h *= 0x9E3779B97F4A7C15ULL; h ^= h >> 29;
+		digest += h;
+	}
+
+	Stats& Stats::operator+=(const Stats& o) {
+		games += o.games; ticks += o.ticks; digest += o.digest;
+		for (uint8_t i { 0 }; i < Causes; ++i) causes[i] += o.causes[i];
+		for (uint16_t i { 0 }; i <= Cells; ++i) { scrans[i] += o.scrans[i]; lengths[i] += o.lengths[i]; }
+		for (uint16_t i { 0 }; i <= SecondsBins; ++i) seconds[i] += o.seconds[i];
+		return *this;
+	}
+
+	// The bin that the fraction f of the games are at or below.
+	template <size_t N>
+	size_t percentile(const uint32_t (&bins)[N], uint64_t total, double f) {
+		uint64_t seen { 0 };
+		for (size_t i { 0 }; i < N; ++i) {
+			seen += bins[i];
+			if (seen > 0 && seen >= f * total) return i;
+		}
+		return N - 1;
+	}
+
+	template <size_t N>
+	double mean(const uint32_t (&bins)[N], uint64_t total) {
+		double sum { 0 };
+		for (size_t i { 0 }; i < N; ++i) sum += static_cast<double>(i) * bins[i];
+		return (total == 0) ? 0 : sum / total;
+	}
+
+
+	// *** Work stealing ***
+
+	struct Options {
+		uint32_t games { 100000 };
+		unsigned threads { std::max(1u, std::thread::hardware_concurrency()) };
+		uint32_t firstSeed { 1 };
+		std::vector<Policy> policies { Policy::Greedy, Policy::Flood };
+		uint32_t maxTicks { 20000 };
+		uint32_t chunk { 64 };
+		const char* csv { nullptr };
+	};
+
+	// The games not played yet [begin, end) in one word so taking and stealing are one
+	//	compare and swap.  Only the owner makes its range bigger and only when it is empty.
+	struct Range {
+		static uint64_t pack(uint32_t begin, uint32_t end) { return (static_cast<uint64_t>(end) << 32) | begin; }
+		static uint32_t begin(uint64_t r) { return static_cast<uint32_t>(r); }
+		static uint32_t end(uint64_t r) { return static_cast<uint32_t>(r >> 32); }
+	};
+
+	// One thread's arena.  On its own cache lines so the threads do not slow each other.
+	struct alignas(64) Worker {
+		std::atomic<uint64_t> range { 0 };
+		GameCore game {};
+		Stats stats {};
+		uint32_t steals { 0 };
+		double busySeconds { 0 };
+	};
+
+	class Pool {
+	public:
+
+		Pool(const Options& o) : options { o }, workers(o.threads) {}
+
+		Stats run(Policy policy);
+		const std::vector<Worker>& threads() const { return workers; }
+
+	private:
+
+		const Options& options;
+		std::vector<Worker> workers;
+
+		bool take(Worker& w, uint32_t& begin, uint32_t& end);
+		bool steal(size_t thief);
+		void work(size_t index, Policy policy);
+		void play(Worker& w, uint32_t game, PolicyFunction choose);
+	};
+
+	bool Pool::take(Worker& w, uint32_t& begin, uint32_t& end) {
+		uint64_t r { w.range.load(std::memory_order_relaxed) };
+		for (;;) {
+			begin = Range::begin(r);
+			if (begin >= Range::end(r)) return false;
+			end = std::min(begin + options.chunk, Range::end(r));
+			if (w.range.compare_exchange_weak(r, Range::pack(end, Range::end(r)), std::memory_order_acq_rel)) return true;
+		}
+	}
+
+	bool Pool::steal(size_t thief) {
+		for (size_t n { 1 }; n < workers.size(); ++n) {
+			Worker& victim { workers[(thief + n) % workers.size()] };
+			uint64_t r { victim.range.load(std::memory_order_relaxed) };
+			for (;;) {
+				const uint32_t begin { Range::begin(r) }, end { Range::end(r) };
+				if (end <= begin + 1) break;
+				const uint32_t middle { begin + (end - begin) / 2 };
+				if (victim.range.compare_exchange_weak(r, Range::pack(begin, middle), std::memory_order_acq_rel)) {
+					workers[thief].range.store(Range::pack(middle, end), std::memory_order_release);
+					++workers[thief].steals;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void Pool::play(Worker& w, uint32_t gameIndex, PolicyFunction choose) {
+
+		const uint32_t seed { options.firstSeed + gameIndex };
+		GameCore& game { w.game };
+		game.reset(seed);
+		Random random { ~seed };
+
+		GameEvents events {};
+		uint32_t ticks { 0 }, played_ms { 0 };
+		while (ticks < options.maxTicks) {
+			played_ms += game.updateTime_ms();
+			events = game.step(choose(game, random));
+			++ticks;
+			if (events.gameOver()) break;
+		}
+
+		Cause cause { Cause::TimedOut };
+		if (events.has(GameEvents::HitWall)) cause = Cause::HitWall;
+		else if (events.has(GameEvents::HitSelf)) cause = Cause::HitSelf;
+		else if (events.has(GameEvents::Won)) cause = Cause::Won;
+		w.stats.add(seed, ticks, game, cause, played_ms);
+	}
+
+	void Pool::work(size_t index, Policy policy) {
+
+		Worker& w { workers[index] };
+		const PolicyFunction choose { policyFunction(policy) };
+		const auto start { std::chrono::steady_clock::now() };
+
+		uint32_t begin, end;
+		for (;;) {
+			while (take(w, begin, end))
+				for (uint32_t g { begin }; g < end; ++g) play(w, g, choose);
+			if (!steal(index)) break;
+		}
+		w.busySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	Stats Pool::run(Policy policy) {
+
+		// An even share each to start with.
+		const size_t n { workers.size() };
+		for (size_t i { 0 }; i < n; ++i) {
+			Worker& w { workers[i] };
+			w.range.store(Range::pack(static_cast<uint32_t>(options.games * i / n), static_cast<uint32_t>(options.games * (i + 1) / n)));
+			w.stats = Stats {};
+			w.steals = 0;
+			w.busySeconds = 0;
+		}
+
+		std::vector<std::thread> threads;
+		for (size_t i { 1 }; i < n; ++i) threads.emplace_back(&Pool::work, this, i, policy);
+		work(0, policy);
+		for (auto& t : threads) t.join();
+
+		Stats total {};
+		for (const auto& w : workers) total += w.stats;
+		return total;
+	}
+
+
+	// *** Reporting ***
+
+	void print(Policy policy, const Stats& s, const Pool& pool, double seconds) {
+
+		const auto& threads { pool.threads() };
+		uint32_t steals { 0 };
+		for (const auto& w : threads) steals += w.steals;
+
+		printf("\n%s: %llu games in %.2f s on %zu threads, %.0f games/s, %.0f games/s a thread, %u steals\n",
+			   policyName(policy), static_cast<unsigned long long>(s.games), seconds, threads.size(),
+			   s.games / seconds, s.games / seconds / threads.size(), steals);
+		for (size_t i { 0 }; i < threads.size(); ++i) {
+			const auto& w { threads[i] };
+			printf("  thread %-3zu %8llu games %8.0f games/s %4u steals\n", i, static_cast<unsigned long long>(w.stats.games),
+				   (w.busySeconds > 0) ? w.stats.games / w.busySeconds : 0.0, w.steals);
+		}
+
+		const double n { (s.games == 0) ? 1.0 : static_cast<double>(s.games) };
+		for (uint8_t c { 0 }; c < Causes; ++c)
+			printf("  %-18s %6.2f%%\n", causeName(static_cast<Cause>(c)), 100.0 * s.causes[c] / n);
+
+		printf("  %-18s mean %7.1f  p10 %5zu  p50 %5zu  p90 %5zu  max %5zu\n", "score",
+			   mean(s.scrans, s.games) * GameCore::scranScore, percentile(s.scrans, s.games, 0.1) * GameCore::scranScore,
+			   percentile(s.scrans, s.games, 0.5) * GameCore::scranScore, percentile(s.scrans, s.games, 0.9) * GameCore::scranScore,
+			   percentile(s.scrans, s.games, 1.0) * GameCore::scranScore);
+		printf("  %-18s mean %7.1f  p10 %5zu  p50 %5zu  p90 %5zu  max %5zu\n", "length",
+			   mean(s.lengths, s.games), percentile(s.lengths, s.games, 0.1), percentile(s.lengths, s.games, 0.5),
+			   percentile(s.lengths, s.games, 0.9), percentile(s.lengths, s.games, 1.0));
+		printf("  %-18s mean %7.1f  p10 %5zu  p50 %5zu  p90 %5zu  (s in bins of %u)\n", "time on device",
+			   mean(s.seconds, s.games) * SecondsPerBin, percentile(s.seconds, s.games, 0.1) * SecondsPerBin,
+			   percentile(s.seconds, s.games, 0.5) * SecondsPerBin, percentile(s.seconds, s.games, 0.9) * SecondsPerBin,
+			   SecondsPerBin);
+		printf("  %-18s %016llX  %llu ticks\n", "digest", static_cast<unsigned long long>(s.digest),
+			   static_cast<unsigned long long>(s.ticks));
+	}
+
+	// policy,histogram,bin,count with the bin as the score, length or seconds it starts at.
+	void writeCsv(FILE* f, Policy policy, const Stats& s) {
+		const char* name { policyName(policy) };
+		for (uint8_t c { 0 }; c < Causes; ++c) fprintf(f, "%s,cause,%s,%u\n", name, causeName(static_cast<Cause>(c)), s.causes[c]);
+		for (uint16_t i { 0 }; i <= Cells; ++i) if (s.scrans[i]) fprintf(f, "%s,score,%u,%u\n", name, i * GameCore::scranScore, s.scrans[i]);
+		for (uint16_t i { 0 }; i <= Cells; ++i) if (s.lengths[i]) fprintf(f, "%s,length,%u,%u\n", name, i, s.lengths[i]);
+		for (uint16_t i { 0 }; i <= SecondsBins; ++i) if (s.seconds[i]) fprintf(f, "%s,seconds,%u,%u\n", name, i * SecondsPerBin, s.seconds[i]);
+	}
+
+	bool parsePolicies(const std::string& list, std::vector<Policy>& policies) {
+		policies.clear();
+		size_t at { 0 };
+		while (at <= list.size()) {
+			const size_t comma { std::min(list.find(',', at), list.size()) };
+			const std::string p { list.substr(at, comma - at) };
+			if (p == "random") policies.push_back(Policy::Random);
+			else if (p == "greedy") policies.push_back(Policy::Greedy);
+			else if (p == "flood") policies.push_back(Policy::Flood);
+			else if (p == "path") policies.push_back(Policy::Path);
+			else if (p == "cycle") policies.push_back(Policy::Cycle);
+			else if (p == "autopilot") policies.push_back(Policy::Autopilot);
+			else return false;
+			at = comma + 1;
+		}
+		return !policies.empty();
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	using namespace Farm;
+
+	Options options {};
+	for (int i { 1 }; i < argc; ++i) {
+		const std::string arg { argv[i] };
+		const bool hasValue { i + 1 < argc };
+		if (arg == "--games" && hasValue) options.games = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--threads" && hasValue) options.threads = static_cast<unsigned>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--seed" && hasValue) options.firstSeed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--max-ticks" && hasValue) options.maxTicks = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--chunk" && hasValue) options.chunk = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+		else if (arg == "--csv" && hasValue) options.csv = argv[++i];
+		else if (arg == "--policy" && hasValue) {
+			if (!parsePolicies(argv[++i], options.policies)) { fprintf(stderr, "Unknown policy in %s\n", argv[i]); return 1; }
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--games n] [--threads n] [--seed n] [--policy random,greedy,flood,path,cycle,autopilot]\n"
+							"          [--max-ticks n] [--chunk n] [--csv file]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (options.threads == 0 || options.chunk == 0 || options.maxTicks == 0) {
+		fprintf(stderr, "--threads, --chunk and --max-ticks have to be more than 0.\n");
+		return 1;
+	}
+
+	FILE* csv { nullptr };
+	if (options.csv != nullptr) {
+		csv = fopen(options.csv, "w");
+		if (csv == nullptr) { fprintf(stderr, "Could not write %s\n", options.csv); return 1; }
+		fprintf(csv, "policy,histogram,bin,count\n");
+	}
+
+	printf("%u games a policy from seed %lu, scran %u points, speed up every %u by 1/%u from %u ms\n",
+		   options.games, static_cast<unsigned long>(options.firstSeed), GameCore::scranScore,
+		   GameCore::speedUpEvery, GameCore::speedUpDivisor, GameCore::updateTimeOnReset_ms);
+
+	Pool pool { options };
+	for (const auto policy : options.policies) {
+		const auto start { std::chrono::steady_clock::now() };
+		const Stats stats { pool.run(policy) };
+		print(policy, stats, pool, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		if (csv != nullptr) writeCsv(csv, policy, stats);
+	}
+
+	if (csv != nullptr) fclose(csv);
+	return 0;
+}
@@ -0,0 +1,475 @@
+// Cycle counting profiler for the uno firmware.
+// Runs the env:uno_profile ELF in simavr on Linux, presses buttons from a script and
+//	answers the SSD1306 on the simulated TWI bus so the firmware runs as it would on
+//	the board.  Every instruction is charged to the function its address falls in and
+//	calls to the functions we care about are timed from entry to return.
+//
+// Build and run with:
+//		pio run -e uno_profile && pio run -e simavr_profiler
+//		.pio/build/simavr_profiler/program .pio/build/uno_profile/firmware.elf tools/simavr_profiler/game.script
+//
+// Options:
+//		--ms <n>		Simulated time to run for (default 20000).
+//		--csv <file>	Write the results as csv.
+//		--frame <file>	Write the last frame on the emulated display as a pbm image.
+//		--track <name>	Time calls to another function (demangled name prefix).
+//
+// Script lines are "<time ms> <UP|DOWN|LEFT|RIGHT|MIDDLE> [down|up]".  Without down
+//	or up the button is pressed for 30 ms.  '#' starts a comment.
+
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <avr_ioport.h>
+#include <avr_twi.h>
+#include <libelf.h>
+#include <gelf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned long cpuFrequency { 16000000UL };
+constexpr const char* mcuName { "atmega328p" };
+
+
+// The buttons on the shield.  Arduino pin numbers from Pin:: mapped to AVR ports.
+struct ButtonPin {
+	const char* name;
+	uint8_t arduinoPin;
+	char port;
+	uint8_t bit;
+};
+
+constexpr ButtonPin buttonPins[] {
+	{ "UP", 	7, 'D', 7 },
+	{ "DOWN", 	8, 'B', 0 },
+	{ "LEFT", 	4, 'D', 4 },
+	{ "RIGHT", 	2, 'D', 2 },
+	{ "MIDDLE", 3, 'D', 3 },
+};
+
+struct ScriptEvent {
+	unsigned long time_ms;
+	const ButtonPin* button;
+	bool pressed;
+};
+
+
+// Function symbols from the ELF.
+struct Symbol {
+	uint32_t start, end;
+	std::string name;
+	uint64_t selfCycles { 0 };
+};
+
+// A function whose calls are timed from entry to return.
+struct Tracked {
+	std::string name;
+	const Symbol* symbol { nullptr };
+	uint64_t calls { 0 }, total { 0 }, min { UINT64_MAX }, max { 0 };
+};
+
+struct Frame {
+	Tracked* tracked;
+	uint16_t sp;
+	uint64_t startCycle;
+};
+
+
+std::string demangle(const char* name) {
+	int status { 0 };
+	char* d { abi::__cxa_demangle(name, nullptr, nullptr, &status) };
+	std::string r { (status == 0 && d != nullptr) ? d : name };
+	free(d);
+	return r;
+}
+
+
+bool loadSymbols(const char* path, std::vector<Symbol>& symbols) {
+
+	if (elf_version(EV_CURRENT) == EV_NONE) return false;
+	const int fd { open(path, O_RDONLY) };
+	if (fd < 0) return false;
+
+	Elf* e { elf_begin(fd, ELF_C_READ, nullptr) };
+	Elf_Scn* scn { nullptr };
+
+	while ((scn = elf_nextscn(e, scn)) != nullptr) {
+
+		GElf_Shdr sh;
+		gelf_getshdr(scn, &sh);
+		if (sh.sh_type != SHT_SYMTAB) continue;
+
+		Elf_Data* data { elf_getdata(scn, nullptr) };
+		const size_t count { sh.sh_size / sh.sh_entsize };
+
+		for (size_t i { 0 }; i < count; ++i) {
+			GElf_Sym sym;
+			gelf_getsym(data, static_cast<int>(i), &sym);
+			if (GELF_ST_TYPE(sym.st_info) != STT_FUNC || sym.st_size == 0) continue;
+			symbols.push_back({ static_cast<uint32_t>(sym.st_value),
+								static_cast<uint32_t>(sym.st_value + sym.st_size),
+								demangle(elf_strptr(e, sh.sh_link, sym.st_name)) });
+		}
+	}
+	elf_end(e);
+	close(fd);
+
+	std::sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) { return a.start < b.start; });
+	return !symbols.empty();
+}
+
+
+bool loadScript(const char* path, std::vector<ScriptEvent>& events) {
+
+	std::ifstream in { path };
+	if (!in) return false;
+
+	std::string line;
+	while (std::getline(in, line)) {
+
+		line = line.substr(0, line.find('#'));
+		std::istringstream ss { line };
+		unsigned long time_ms;
+		std::string name, action;
+		if (!(ss >> time_ms >> name)) continue;
+		ss >> action;
+
+		const ButtonPin* button { nullptr };
+		for (const auto& b : buttonPins)
+			if (name == b.name) button = &b;
+		if (button == nullptr) {
+			fprintf(stderr, "Unknown button '%s' in script.\n", name.c_str());
+			return false;
+		}
+
+		if (action == "up") events.push_back({ time_ms, button, false });
+		else if (action == "down") events.push_back({ time_ms, button, true });
+		else {
+			events.push_back({ time_ms, button, true });
+			events.push_back({ time_ms + 30, button, false });
+		}
+	}
+	std::stable_sort(events.begin(), events.end(), [](const ScriptEvent& a, const ScriptEvent& b) { return a.time_ms < b.time_ms; });
+	return true;
+}
+
+
+// Enough of an SSD1306 to acknowledge the firmware and keep a copy of the display RAM.
+//	Assumes horizontal addressing which is what the Adafruit library uses.
+struct Ssd1306 {
+
+	static constexpr uint8_t address { 0x3C };
+
+	avr_irq_t* irqIn { nullptr };
+	bool selected { false };
+	bool dataMode { false };
+	bool controlNext { false };
+	uint8_t command { 0 };
+	uint8_t paramsWanted { 0 };
+	uint8_t params[2] {};
+	uint8_t paramCount { 0 };
+
+	uint8_t colStart { 0 }, colEnd { 127 }, pageStart { 0 }, pageEnd { 7 };
+	uint8_t col { 0 }, page { 0 };
+	uint8_t ram[8][128] {};
+
+	uint64_t transactions { 0 }, bytes { 0 }, dataBytes { 0 };
+
+	static uint8_t parameterCount(uint8_t cmd) {
+		switch (cmd) {
+			case 0x21: case 0x22: return 2;
+			case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+			case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+			default: return 0;
+		}
+	}
+
+	void doCommand() {
+		if (command == 0x21) { colStart = params[0] & 0x7F; colEnd = params[1] & 0x7F; col = colStart; }
+		if (command == 0x22) { pageStart = params[0] & 0x07; pageEnd = params[1] & 0x07; page = pageStart; }
+	}
+
+	void receive(uint8_t byte) {
+
+		++bytes;
+		if (controlNext) {
+			dataMode = (byte & 0x40) != 0;
+			controlNext = false;
+			return;
+		}
+
+		if (dataMode) {
+			++dataBytes;
+			ram[page][col] = byte;
+			if (col++ >= colEnd) {
+				col = colStart;
+				if (page++ >= pageEnd) page = pageStart;
+			}
+			return;
+		}
+
+		if (paramsWanted > 0) {
+			params[paramCount++] = byte;
+			if (--paramsWanted == 0) doCommand();
+			return;
+		}
+		command = byte;
+		paramCount = 0;
+		paramsWanted = parameterCount(byte);
+	}
+
+	static void onTwi(avr_irq_t*, uint32_t value, void* param) {
+
+		auto& d { *static_cast<Ssd1306*>(param) };
+		avr_twi_msg_irq_t v;
+		v.u.v = value;
+
+		if (v.u.twi.msg & TWI_COND_STOP) d.selected = false;
+
+		if (v.u.twi.msg & TWI_COND_START) {
+			d.selected = ((v.u.twi.addr >> 1) == address) && !(v.u.twi.addr & 1);
+			if (d.selected) {
+				++d.transactions;
+				d.controlNext = true;
+				avr_raise_irq(d.irqIn, avr_twi_irq_msg(TWI_COND_ACK, v.u.twi.addr, 1));
+			}
+		}
+
+		if (d.selected && (v.u.twi.msg & TWI_COND_WRITE)) {
+			avr_raise_irq(d.irqIn, avr_twi_irq_msg(TWI_COND_ACK, address << 1, 1));
+			d.receive(v.u.twi.data);
+		}
+	}
+
+	void connect(avr_t* avr) {
+		irqIn = avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+		avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), onTwi, this);
+	}
+
+	bool writePbm(const char* path) const {
+		FILE* f { fopen(path, "w") };
+		if (f == nullptr) return false;
+		fprintf(f, "P1\n128 64\n");
+		for (int y { 0 }; y < 64; ++y) {
+			for (int x { 0 }; x < 128; ++x)
+				fputc(((ram[y / 8][x] >> (y % 8)) & 1) ? '1' : '0', f);
+			fputc('\n', f);
+		}
+		fclose(f);
+		return true;
+	}
+};
+
+
+class Profiler {
+public:
+	explicit Profiler(std::vector<Symbol>& symbols) : symbols{symbols} {}
+
+	bool track(const std::string& name) {
+		for (const auto& s : symbols) {
+			if (s.name.compare(0, name.size(), name) == 0) {
+				tracked.push_back({ s.name, &s });
+				return true;
+			}
+		}
+		tracked.push_back({ name, nullptr });
+		return false;
+	}
+
+	// Called after every instruction with the pc it ran at and the cycles it took.
+	void step(uint32_t pc, uint32_t newPc, uint16_t sp, uint64_t cycles, uint64_t now) {
+
+		Symbol* s { find(pc) };
+		if (s != nullptr) s->selfCycles += cycles;
+		else unknownCycles += cycles;
+
+		// A return has happened once the stack is above where it was at entry.
+		while (!frames.empty() && sp > frames.back().sp) {
+			auto& f { frames.back() };
+			auto& t { *f.tracked };
+			const uint64_t c { now - f.startCycle };
+			++t.calls;
+			t.total += c;
+			t.min = std::min(t.min, c);
+			t.max = std::max(t.max, c);
+			frames.pop_back();
+		}
+
+		// An entry is a jump to the first instruction from outside the function.
+		for (auto& t : tracked) {
+			if (t.symbol != nullptr && newPc == t.symbol->start && (pc < t.symbol->start || pc >= t.symbol->end))
+				frames.push_back({ &t, sp, now });
+		}
+	}
+
+	void report(FILE* out, uint64_t totalCycles) const {
+
+		fprintf(out, "\n%-40s %8s %12s %10s %10s %10s %10s\n", "function (inclusive)", "calls", "total", "min", "mean", "max", "mean us");
+		for (const auto& t : tracked) {
+			if (t.symbol == nullptr) { fprintf(out, "%-40s not in ELF (inlined?)\n", t.name.c_str()); continue; }
+			if (t.calls == 0) { fprintf(out, "%-40s %8s\n", t.name.c_str(), "0"); continue; }
+			const double mean { static_cast<double>(t.total) / static_cast<double>(t.calls) };
+			fprintf(out, "%-40.40s %8llu %12llu %10llu %10.0f %10llu %10.1f\n", t.name.c_str(),
+					static_cast<unsigned long long>(t.calls), static_cast<unsigned long long>(t.total),
+					static_cast<unsigned long long>(t.min), mean, static_cast<unsigned long long>(t.max),
+					mean * 1e6 / cpuFrequency);
+		}
+
+		std::vector<const Symbol*> bySelf;
+		for (const auto& s : symbols) if (s.selfCycles > 0) bySelf.push_back(&s);
+		std::sort(bySelf.begin(), bySelf.end(), [](const Symbol* a, const Symbol* b) { return a->selfCycles > b->selfCycles; });
+
+		fprintf(out, "\n%-60s %14s %7s\n", "function (self)", "cycles", "%");
+		for (size_t i { 0 }; i < bySelf.size() && i < 30; ++i)
+			fprintf(out, "%-60.60s %14llu %6.2f%%\n", bySelf[i]->name.c_str(),
+					static_cast<unsigned long long>(bySelf[i]->selfCycles), 100.0 * bySelf[i]->selfCycles / totalCycles);
+		fprintf(out, "%-60s %14llu %6.2f%%\n", "(no symbol)", static_cast<unsigned long long>(unknownCycles), 100.0 * unknownCycles / totalCycles);
+	}
+
+	bool writeCsv(const char* path) const {
+		FILE* f { fopen(path, "w") };
+		if (f == nullptr) return false;
+		fprintf(f, "kind,function,calls,total_cycles,min_cycles,max_cycles\n");
+		for (const auto& t : tracked)
+			if (t.calls > 0)
+				fprintf(f, "inclusive,\"%s\",%llu,%llu,%llu,%llu\n", t.name.c_str(),
+						static_cast<unsigned long long>(t.calls), static_cast<unsigned long long>(t.total),
+						static_cast<unsigned long long>(t.min), static_cast<unsigned long long>(t.max));
+		for (const auto& s : symbols)
+			if (s.selfCycles > 0)
+				fprintf(f, "self,\"%s\",,%llu,,\n", s.name.c_str(), static_cast<unsigned long long>(s.selfCycles));
+		fclose(f);
+		return true;
+	}
+
+private:
+	Symbol* find(uint32_t pc) {
+		auto it { std::upper_bound(symbols.begin(), symbols.end(), pc, [](uint32_t a, const Symbol& s) { return a < s.start; }) };
+		if (it == symbols.begin()) return nullptr;
+		--it;
+		return (pc < it->end) ? &*it : nullptr;
+	}
+
+	std::vector<Symbol>& symbols;
+	std::vector<Tracked> tracked;
+	std::vector<Frame> frames;
+	uint64_t unknownCycles { 0 };
+};
+
+
+uint16_t stackPointer(const avr_t* avr) {
+	return static_cast<uint16_t>(avr->data[R_SPL] | (avr->data[R_SPH] << 8));
+}
+
+void setButton(avr_t* avr, const ButtonPin& b, bool pressed) {
+	// The buttons pull the pin low when pressed.
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(b.port), b.bit), pressed ? 0 : 1);
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+
+	const char* elfPath { nullptr };
+	const char* scriptPath { nullptr };
+	const char* csvPath { nullptr };
+	const char* framePath { nullptr };
+	unsigned long runFor_ms { 20000 };
+	std::vector<std::string> extraTracked;
+
+	for (int i { 1 }; i < argc; ++i) {
+		if (!strcmp(argv[i], "--ms") && i + 1 < argc) runFor_ms = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--csv") && i + 1 < argc) csvPath = argv[++i];
+		else if (!strcmp(argv[i], "--frame") && i + 1 < argc) framePath = argv[++i];
+		else if (!strcmp(argv[i], "--track") && i + 1 < argc) extraTracked.push_back(argv[++i]);
+		else if (elfPath == nullptr) elfPath = argv[i];
+		else scriptPath = argv[i];
+	}
+
+	if (elfPath == nullptr) {
+		fprintf(stderr, "usage: %s firmware.elf [script] [--ms n] [--csv file] [--frame file] [--track name]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<Symbol> symbols;
+	if (!loadSymbols(elfPath, symbols)) {
+		fprintf(stderr, "No function symbols in %s.\n", elfPath);
+		return 1;
+	}
+
+	std::vector<ScriptEvent> script;
+	if (scriptPath != nullptr && !loadScript(scriptPath, script)) {
+		fprintf(stderr, "Could not read script %s.\n", scriptPath);
+		return 1;
+	}
+
+	elf_firmware_t firmware {};
+	if (elf_read_firmware(elfPath, &firmware) != 0) {
+		fprintf(stderr, "Could not load %s.\n", elfPath);
+		return 1;
+	}
+
+	avr_t* avr { avr_make_mcu_by_name(mcuName) };
+	if (avr == nullptr) {
+		fprintf(stderr, "simavr does not know the %s.\n", mcuName);
+		return 1;
+	}
+	avr_init(avr);
+	avr->frequency = cpuFrequency;
+	avr_load_firmware(avr, &firmware);
+
+	Ssd1306 screen {};
+	screen.connect(avr);
+	for (const auto& b : buttonPins) setButton(avr, b, false);
+
+	Profiler profiler { symbols };
+	for (const char* name : { "updateGame()", "readButtons()", "Adafruit_SSD1306::display()",
+							  "drawSnake(", "placeRandomScran()", "doGameOver()", "doHighScore()",
+							  "doPaused()", "doSplashScreen()" })
+		profiler.track(name);
+	for (const auto& name : extraTracked) profiler.track(name);
+
+	const uint64_t endCycle { static_cast<uint64_t>(runFor_ms) * (cpuFrequency / 1000) };
+	size_t nextEvent { 0 };
+	int state { cpu_Running };
+
+	while (state != cpu_Done && state != cpu_Crashed && avr->cycle < endCycle) {
+
+		const unsigned long now_ms { static_cast<unsigned long>(avr->cycle / (cpuFrequency / 1000)) };
+		while (nextEvent < script.size() && script[nextEvent].time_ms <= now_ms) {
+			setButton(avr, *script[nextEvent].button, script[nextEvent].pressed);
+			++nextEvent;
+		}
+
+		const uint32_t pc { avr->pc };
+		const uint64_t before { avr->cycle };
+		state = avr_run(avr);
+		profiler.step(pc, avr->pc, stackPointer(avr), avr->cycle - before, avr->cycle);
+	}
+
+	if (state == cpu_Crashed) fprintf(stderr, "The firmware crashed at pc 0x%04x.\n", avr->pc);
+
+	printf("Simulated %.3f s (%llu cycles) of %s.\n", static_cast<double>(avr->cycle) / cpuFrequency,
+		   static_cast<unsigned long long>(avr->cycle), elfPath);
+	printf("SSD1306: %llu transactions, %llu bytes, %llu display bytes.\n",
+		   static_cast<unsigned long long>(screen.transactions), static_cast<unsigned long long>(screen.bytes),
+		   static_cast<unsigned long long>(screen.dataBytes));
+	profiler.report(stdout, avr->cycle);
+
+	if (csvPath != nullptr && !profiler.writeCsv(csvPath)) fprintf(stderr, "Could not write %s.\n", csvPath);
+	if (framePath != nullptr && !screen.writePbm(framePath)) fprintf(stderr, "Could not write %s.\n", framePath);
+	return (state == cpu_Crashed) ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+// Trace decoder
+// Prints the "TRACE <hex>" lines of a saved serial log from a debug build (see Trace.hpp)
+//	as a record a line with the whole tick count, and the rest of the log as it was.
+//	Built by the trace_decoder environment in platformio.ini:
+//		pio run -e trace_decoder && .pio/build/trace_decoder/program [--only] [log]
+//	Reads the standard input if no log is given.
+//
+//	Options:
+//		--only			Only print the records, not the other lines of the log.
+
+#include <string>
+#include "Trace.hpp"
+
+
+namespace Decoder {
+
+	using Trace::Id;
+
+	struct Options {
+		const char* path { nullptr };
+		bool only { false };
+	};
+
+	int hexValue(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	enum class Kind { Number, Cell, Direction };
+
+	struct Description {
+		const char* name;
+		Kind kind;
+	};
+
+	// In the order of Trace::Id.
+	constexpr Description descriptions[] {
+		{ "tick", 		Kind::Number },
+		{ "input", 		Kind::Direction },
+		{ "moved", 		Kind::Cell },
+		{ "tail", 		Kind::Cell },
+		{ "scran", 		Kind::Cell },
+		{ "ate", 		Kind::Number },
+		{ "hit wall", 	Kind::Cell },
+		{ "hit self", 	Kind::Cell },
+		{ "bad insert",	Kind::Cell },
+		{ "autopilot", 	Kind::Number },
+		{ "lost", 		Kind::Number }
+	};
+	static_assert(sizeof(descriptions) / sizeof(descriptions[0]) == static_cast<size_t>(Id::Lost) + 1, "A description for each Trace::Id.");
+
+	const char* directionName(uint16_t d) {
+		static const char* const names[] { "up", "left", "right", "down", "none", "middle" };
+		return (d < sizeof(names) / sizeof(names[0])) ? names[d] : "?";
+	}
+
+	// Turns the tick's low byte back in to the whole count.  Records come in order so a
+	//	low byte less than the last one has gone past a multiple of 256.
+	class Ticks {
+		uint32_t m_tick { 0 };
+	public:
+		uint32_t next(const Trace::Record& r) {
+			if (r.id == Id::Tick) m_tick = r.value;
+			else {
+				uint32_t t { (m_tick & ~0xFFu) | r.tick };
+				if (t < m_tick) t += 0x100;
+				m_tick = t;
+			}
+			return m_tick;
+		}
+	};
+
+	void print(const Trace::Record& r, uint32_t tick) {
+
+		const auto i { static_cast<size_t>(r.id) };
+		if (i >= sizeof(descriptions) / sizeof(descriptions[0])) {
+			printf("%8u  id %u  %u\n", static_cast<unsigned>(tick), static_cast<unsigned>(i), r.value);
+			return;
+		}
+		const Description& d { descriptions[i] };
+		printf("%8u  %-10s  ", static_cast<unsigned>(tick), d.name);
+		switch (d.kind) {
+			case Kind::Cell: 		printf("(%u, %u)\n", r.value >> 8, r.value & 0xFF); break;
+			case Kind::Direction: 	printf("%s\n", directionName(r.value)); break;
+			default: 				printf("%u\n", r.value);
+		}
+	}
+
+	// The records in a line, or false if it is not a whole trace line.
+	bool decode(const std::string& line, std::string& bytes) {
+
+		if (line.compare(0, 6, "TRACE ") != 0) return false;
+		bytes.clear();
+		size_t i { 6 };
+		for (; i + 1 < line.size(); i += 2) {
+			const int hi { hexValue(line[i]) }, lo { hexValue(line[i + 1]) };
+			if (hi < 0 || lo < 0) break;
+			bytes.push_back(static_cast<char>((hi << 4) | lo));
+		}
+		return bytes.size() % Trace::recordSize == 0 && !bytes.empty();
+	}
+
+	int run(FILE* in, const Options& options) {
+
+		Ticks ticks {};
+		std::string line, bytes;
+		unsigned long records { 0 }, lost { 0 };
+
+		for (int c { fgetc(in) }; c != EOF || !line.empty(); c = fgetc(in)) {
+
+			if (c != '\n' && c != EOF) { if (c != '\r') line.push_back(static_cast<char>(c)); continue; }
+
+			if (decode(line, bytes)) {
+				for (size_t i { 0 }; i < bytes.size(); i += Trace::recordSize) {
+					const Trace::Record r { static_cast<Id>(bytes[i]), static_cast<uint8_t>(bytes[i + 1]),
+											static_cast<uint16_t>(static_cast<uint8_t>(bytes[i + 2]) | (static_cast<uint8_t>(bytes[i + 3]) << 8)) };
+					print(r, ticks.next(r));
+					if (r.id == Id::Lost) lost += r.value;
+					else ++records;
+				}
+			}
+			else if (!options.only) printf("%s\n", line.c_str());
+			line.clear();
+			if (c == EOF) break;
+		}
+
+		printf("%lu records, %lu lost.\n", records, lost);
+		return 0;
+	}
+}
+
+
+int main(int argc, char** argv) {
+
+	Decoder::Options options {};
+
+	for (int i { 1 }; i < argc; ++i) {
+		const std::string arg { argv[i] };
+		if (arg == "--only") options.only = true;
+		else if (arg[0] == '-') {
+			fprintf(stderr, "Usage: %s [--only] [log]\n", argv[0]);
+			return 1;
+		}
+		else options.path = argv[i];
+	}
+
+	FILE* f { (options.path != nullptr) ? fopen(options.path, "rb") : stdin };
+	if (f == nullptr) {
+		fprintf(stderr, "Could not open %s\n", options.path);
+		return 1;
+	}
+	const int result { Decoder::run(f, options) };
+	if (f != stdin) fclose(f);
+	return result;
+}